@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <imgui.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace maolan::ui {
+class Damage {
+public:
+  class Command {
+  public:
+    ImDrawCmd cmd;
+    std::size_t hash;
+    ImVec4 bounds;
+  };
+
+  class Snapshot {
+  public:
+    std::vector<Command> commands;
+    int used;
+  };
+
+  static Damage *get();
+
+  void add(const ImVec2 &minimum, const ImVec2 &maximum);
+  void add(const ImVec4 &rect);
+  void full();
+  void reported(ImDrawCallback callback);
+  void compute(ImDrawData *data);
+  bool empty() const;
+  bool region(const int &age, ImVec4 &rect) const;
+  void clip(ImDrawData *data, const ImVec4 &rect) const;
+  void present();
+
+protected:
+  Damage();
+
+  Command measure(const ImDrawList *drawList, const ImDrawCmd &cmd) const;
+  void changed(const Command &command);
+  void list(const ImDrawList *drawList, Snapshot &snapshot);
+
+  std::map<const char *, Snapshot> _snapshots;
+  std::vector<const char *> _order;
+  std::set<ImDrawCallback> _reported;
+  std::vector<Command> _scratch;
+  std::array<ImVec4, 4> _history;
+  std::size_t _frames;
+  ImVec4 _current;
+  ImVec2 _display;
+  bool _full;
+
+  static Damage *damage;
+};
+} // namespace maolan::ui
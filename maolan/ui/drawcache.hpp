@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <imgui.h>
+#include <map>
+#include <utility>
+
+namespace maolan::ui {
+class DrawCache {
+public:
+  class Entry {
+  public:
+    Entry();
+
+    ImVector<ImDrawVert> vertices;
+    ImVector<ImDrawIdx> indices;
+    ImVec2 origin;
+    std::size_t key;
+    int used;
+    bool valid;
+  };
+
+  static DrawCache *get();
+  template <typename T> static void hash(std::size_t &seed, const T &value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  static void splice(ImDrawList *drawList, const ImVector<ImDrawVert> &vertices,
+                     const ImVector<ImDrawIdx> &indices, const ImVec2 &offset);
+  static void splice(ImDrawList *drawList, const ImDrawVert *vertices,
+                     const int &vertexCount, const ImDrawIdx *indices,
+                     const int &indexCount, const ImVec2 &offset);
+  static void splice(ImDrawList *drawList, const ImDrawList *source);
+
+  void frame();
+  std::size_t style() const;
+  bool replay(const void *owner, const int &slot, const std::size_t &key,
+              const ImVec2 &origin);
+  void begin(const void *owner, const int &slot, const std::size_t &key,
+             const ImVec2 &origin);
+  void end();
+
+protected:
+  DrawCache();
+
+  using Index = std::pair<const void *, int>;
+  std::map<Index, Entry> _entries;
+  Entry *_recording;
+  ImDrawList *_list;
+  unsigned int _vertex;
+  int _vertices;
+  int _indices;
+  int _commands;
+  std::size_t _style;
+
+  static DrawCache *cache;
+};
+} // namespace maolan::ui
@@ -0,0 +1,22 @@
+#pragma once
+#include <maolan/ui/glfw/ring.hpp>
+#include <maolan/ui/primitives.hpp>
+
+namespace maolan::ui {
+class GLPrimitives : public Primitives {
+public:
+  GLPrimitives();
+  ~GLPrimitives();
+
+  static bool supported();
+
+  virtual void draw(const Batch &batch, const ImDrawCmd &cmd);
+  void fence();
+
+protected:
+  unsigned int _program;
+  unsigned int _vao;
+  int _projection;
+  Ring _instances;
+};
+} // namespace maolan::ui
@@ -0,0 +1,26 @@
+#pragma once
+#include <imgui.h>
+#include <maolan/ui/glfw/ring.hpp>
+
+namespace maolan::ui {
+class GLRenderer {
+public:
+  GLRenderer();
+  ~GLRenderer();
+
+  static bool supported();
+
+  void render(ImDrawData *data);
+  void fence();
+
+protected:
+  void setup(ImDrawData *data, const int &width, const int &height);
+
+  unsigned int _program;
+  unsigned int _vao;
+  int _projection;
+  int _texture;
+  Ring _vertices;
+  Ring _indices;
+};
+} // namespace maolan::ui
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace maolan::ui {
+class Ring {
+public:
+  Ring(const unsigned int &target, const std::size_t &size);
+  ~Ring();
+
+  static bool persistent();
+
+  std::size_t write(const void *data, const std::size_t &bytes,
+                    const std::size_t &alignment = 1);
+  void fence();
+  unsigned int buffer() const;
+
+protected:
+  void allocate(const std::size_t &size);
+  void wait(const std::size_t &region);
+
+  static const std::size_t regions = 3;
+
+  unsigned int _target;
+  unsigned int _buffer;
+  std::size_t _size;
+  std::size_t _offset;
+  std::size_t _region;
+  std::array<void *, regions> _fences;
+  unsigned char *_mapped;
+  bool _persistent;
+};
+} // namespace maolan::ui
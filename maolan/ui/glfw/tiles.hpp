@@ -0,0 +1,20 @@
+#pragma once
+#include <maolan/ui/tiles.hpp>
+
+namespace maolan::ui {
+class GLRenderer;
+class GLTiles : public Tiles {
+public:
+  GLTiles(GLRenderer *renderer);
+  ~GLTiles();
+
+  virtual void render(const std::vector<Job> &jobs);
+
+protected:
+  virtual ImTextureID allocate(const ImVec2 &size);
+  virtual void release(ImTextureID texture);
+
+  GLRenderer *_renderer;
+  unsigned int _framebuffer;
+};
+} // namespace maolan::ui
@@ -1,13 +1,38 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <imgui.h>
+#include <maolan/ui/tiles.hpp>
 #include <maolan/ui/ui.hpp>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 class GLFWwindow;
 
 namespace maolan::ui {
 class App;
+class GLPrimitives;
+class GLRenderer;
+class GLTiles;
+class GLUploads;
+class GLWaveforms;
 class GLFW : public UI {
 public:
+  class Frame {
+  public:
+    ImDrawData data;
+    std::vector<ImDrawList *> lists;
+    std::vector<Tiles::Job> tiles;
+    ImVec4 rect;
+    int width;
+    int height;
+    void *fence;
+    bool partial;
+    bool presented;
+  };
+
   GLFW(const std::string &title = "Maolan");
   ~GLFW();
 
@@ -16,6 +41,37 @@ public:
   virtual void run(App *app);
 
 protected:
+  int age();
+  void expect(const double &start);
+  void tasks(const double &deadline);
+  void wait();
+  void build(Frame &frame, const bool &clone);
+  void submit(Frame &frame);
+  void release(Frame &frame);
+  void pipeline(const bool &on);
+  void loop();
+  void idle();
+
   GLFWwindow *_window;
+  GLFWwindow *_shared;
+  GLRenderer *_renderer;
+  GLTiles *_tiles;
+  GLPrimitives *_primitives;
+  GLUploads *_uploads;
+  GLWaveforms *_waveforms;
+  Frame _frame;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  double _period;
+  double _build;
+  double _submit;
+  double _deadline;
+  std::atomic<double> _vsync;
+  std::atomic<double> _submitted;
+  bool _bufferAge;
+  bool _presented;
+  bool _busy;
+  bool _quit;
 };
 } // namespace maolan::ui
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <maolan/ui/glfw/ring.hpp>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace maolan::ui {
+class GLUploads {
+public:
+  class Upload {
+  public:
+    std::shared_ptr<const void> owner;
+    const void *pixels;
+    std::size_t bytes;
+    unsigned int texture;
+    int x;
+    int y;
+    int width;
+    int height;
+    unsigned int format;
+    unsigned int type;
+    uint64_t ticket;
+  };
+
+  GLUploads(const std::size_t &budget = 4 << 20);
+  ~GLUploads();
+
+  static bool supported();
+
+  uint64_t post(const Upload &upload);
+  bool ready(const uint64_t &ticket);
+  std::size_t pending();
+  void pump();
+
+protected:
+  void poll();
+
+  Ring _ring;
+  std::deque<Upload> _queue;
+  std::deque<std::pair<uint64_t, void *>> _fences;
+  std::mutex _mutex;
+  std::size_t _budget;
+  uint64_t _posted;
+  uint64_t _completed;
+};
+} // namespace maolan::ui
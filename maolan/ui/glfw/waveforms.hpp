@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <maolan/ui/waveforms.hpp>
+#include <memory>
+
+namespace maolan::ui {
+class GLUploads;
+class GLWaveforms : public Waveforms {
+public:
+  class Texture {
+  public:
+    std::shared_ptr<Peaks> peaks;
+    unsigned int id;
+    uint64_t used;
+    uint64_t ticket;
+  };
+
+  GLWaveforms(GLUploads *uploads);
+  ~GLWaveforms();
+
+  static bool supported();
+
+  virtual bool fits(const Peaks &peaks) const;
+  virtual bool prepare(Wave &wave);
+  virtual void render(const Wave &wave, const ImDrawCmd &cmd);
+  void collect();
+
+protected:
+  GLUploads *_uploads;
+  unsigned int _program;
+  unsigned int _vao;
+  int _projection;
+  int _rect;
+  int _origin;
+  int _offset;
+  int _zoom;
+  int _gain;
+  int _base;
+  int _channels;
+  int _split;
+  int _stride;
+  int _levels;
+  int _offsets;
+  int _sizes;
+  int _tint;
+  int _maxSize;
+  uint64_t _frame;
+  std::map<const Peaks *, Texture> _textures;
+};
+} // namespace maolan::ui
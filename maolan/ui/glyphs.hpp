@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <imgui.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace maolan::ui {
+class Glyphs {
+public:
+  class Key {
+  public:
+    int format;
+    int64_t value;
+    uint64_t extra;
+
+    bool operator==(const Key &other) const;
+  };
+
+  class Run {
+  public:
+    std::vector<ImVec4> quads;
+    std::vector<ImVec4> uvs;
+    float width;
+    int used;
+  };
+
+  static Glyphs *get();
+
+  const Run *find(const Key &key);
+  const Run *shape(const Key &key, const std::string &text);
+  static void draw(ImDrawList *drawList, const Run *run,
+                   const ImVec2 &position, const ImU32 &color);
+  void sweep();
+
+protected:
+  class Hash {
+  public:
+    std::size_t operator()(const Key &key) const;
+  };
+
+  Glyphs();
+
+  std::unordered_map<Key, Run, Hash> _runs;
+  const ImFont *_font;
+  float _size;
+  int _swept;
+
+  static Glyphs *glyphs;
+};
+} // namespace maolan::ui
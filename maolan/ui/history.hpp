@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <maolan/ui/transaction.hpp>
+#include <unordered_map>
+#include <utility>
+
+namespace maolan::ui {
+class History {
+public:
+  static History *get();
+
+  void record(Transaction &&transaction);
+  void hold(const Transaction &transaction);
+  void undo();
+  void redo();
+  void forget(const audio::Clip *clip);
+  void forget(const audio::Track *track);
+  bool undoable() const;
+  bool redoable() const;
+  std::size_t bytes() const;
+  std::size_t budget() const;
+  void budget(const std::size_t &bytes);
+
+protected:
+  History();
+
+  static std::size_t size(const Transaction &transaction);
+  template <typename K>
+  void forget(std::deque<Transaction> &transactions, const K *key);
+  void trim();
+
+  std::deque<Transaction> _done;
+  std::deque<Transaction> _undone;
+  std::unordered_map<audio::Clip *, std::pair<uint64_t, uint64_t>> _held;
+  std::size_t _bytes;
+  std::size_t _budget;
+
+  static History *history;
+};
+} // namespace maolan::ui
@@ -0,0 +1,21 @@
+#pragma once
+#include <array>
+
+namespace maolan::ui {
+class LOD {
+public:
+  LOD(const float &zoom);
+
+  float alpha(const int &bar) const;
+
+  int step;
+  int coarse;
+  float fade;
+
+protected:
+  static void build(const float &spt);
+
+  static std::array<int, 32> steps;
+  static float spt;
+};
+} // namespace maolan::ui
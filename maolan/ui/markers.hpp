@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace maolan::ui {
+class Markers {
+public:
+  class Marker {
+  public:
+    uint64_t start;
+    uint64_t end;
+    std::string name;
+    uint64_t reach;
+  };
+
+  static Markers *get();
+
+  void add(const uint64_t &start, const uint64_t &end,
+           const std::string &name);
+  void add(std::vector<Marker> &markers);
+  void clear();
+  void visible(const double &from, const double &to,
+               std::vector<const Marker *> &found) const;
+  bool next(const double &position, uint64_t &target) const;
+  bool previous(const double &position, uint64_t &target) const;
+  void positions(std::vector<uint64_t> &out) const;
+  std::size_t size() const;
+  uint64_t version() const;
+
+protected:
+  Markers();
+
+  static void index(std::vector<Marker> &markers);
+
+  std::vector<Marker> _points;
+  std::vector<Marker> _ranges;
+  uint64_t _version;
+
+  static Markers *markers;
+};
+} // namespace maolan::ui
@@ -1,9 +1,16 @@
 #pragma once
+#include <cstdint>
 
 namespace maolan::ui {
 class App;
 class Menu {
 public:
   void draw(App *app);
+
+protected:
+  uint64_t beat();
+  void region();
+  void ruler();
+  void tempo();
 };
 } // namespace maolan::ui
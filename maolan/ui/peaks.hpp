@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <imgui.h>
+#include <map>
+#include <maolan/audio/clip.hpp>
+#include <maolan/ui/scheduler.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maolan::ui {
+class Peaks {
+public:
+  using Source = std::function<bool(audio::Clip *clip,
+                                    std::vector<float> &samples,
+                                    std::size_t &channels)>;
+
+  Peaks();
+
+  static std::shared_ptr<Peaks>
+  get(audio::Clip *clip,
+      const Scheduler::Priority &priority = Scheduler::Visible);
+  static std::shared_ptr<Peaks> find(audio::Clip *clip);
+  static void forget(audio::Clip *clip);
+  static uint64_t version();
+
+  ImVec2 peak(const std::size_t &channel, const std::size_t &level,
+              const std::size_t &from, const std::size_t &to) const;
+  std::size_t level(const float &zoom) const;
+  std::size_t index(const std::size_t &channel, const std::size_t &level,
+                    const std::size_t &block) const;
+  void build(const std::vector<float> &samples, const std::size_t &channels);
+
+  static const std::size_t base = 64;
+  static Source source;
+
+  std::size_t channels;
+  std::size_t frames;
+  std::size_t stride;
+  std::vector<std::size_t> offsets;
+  std::vector<std::size_t> sizes;
+  std::vector<ImVec2> data;
+  std::vector<std::size_t> transients;
+  std::atomic<bool> ready;
+
+protected:
+  void detect();
+
+  static std::map<audio::Clip *, std::shared_ptr<Peaks>> peaks;
+  static std::mutex mutex;
+  static uint64_t published;
+};
+} // namespace maolan::ui
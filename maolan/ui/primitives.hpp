@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <imgui.h>
+#include <vector>
+
+namespace maolan::ui {
+class Primitives {
+public:
+  class Rect {
+  public:
+    ImVec2 min;
+    ImVec2 max;
+    ImU32 color;
+  };
+
+  class Batch {
+  public:
+    void clip(const ImVec2 &minimum, const ImVec2 &maximum);
+    void rect(const ImVec2 &minimum, const ImVec2 &maximum, const ImU32 &color,
+              const float &rounding = 0);
+    void outline(const ImVec2 &minimum, const ImVec2 &maximum,
+                 const ImU32 &color, const float &rounding = 0);
+    void line(const float &x, const float &top, const float &bottom,
+              const ImU32 &color);
+    void span(const float &x, const float &top, const float &bottom,
+              const ImU32 &color);
+
+    std::vector<Rect> rects;
+    ImDrawList *drawList;
+    ImVec4 clipRect;
+    bool instanced;
+    bool screen;
+  };
+
+  virtual ~Primitives();
+
+  static Primitives *get();
+  static Batch *batch(ImDrawList *drawList, const bool &screen = true);
+  static void finish();
+
+  void target(const ImDrawData *data);
+  virtual void draw(const Batch &batch, const ImDrawCmd &cmd) = 0;
+
+protected:
+  Primitives();
+
+  static void callback(const ImDrawList *drawList, const ImDrawCmd *cmd);
+
+  const ImDrawData *_target;
+
+  static std::vector<Batch *> batches[2];
+  static std::size_t used[2];
+  static int current;
+  static Primitives *primitives;
+};
+} // namespace maolan::ui
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace maolan::ui {
+template <typename K, typename T> class Registry {
+  using Objects = std::vector<std::unique_ptr<T>>;
+
+public:
+  class Iterator {
+  public:
+    Iterator(const typename Objects::iterator &it) : _it{it} {}
+
+    T &operator*() const { return **_it; }
+    Iterator &operator++() {
+      ++_it;
+      return *this;
+    }
+    bool operator!=(const Iterator &other) const { return _it != other._it; }
+
+  protected:
+    typename Objects::iterator _it;
+  };
+
+  Registry() : _frame{0} {}
+
+  template <typename... Args> T *get(K *key, Args &&...args) {
+    const uint64_t handle = (uintptr_t)key->data();
+    const uint32_t index = handle & 0xffffffff;
+    const uint32_t generation = handle >> 32;
+    if (index > 0 && index <= _slots.size() &&
+        _slots[index - 1].generation == generation) {
+      const auto dense = _slots[index - 1].dense;
+      _used[dense] = _frame;
+      return _objects[dense].get();
+    }
+    uint32_t slot;
+    if (_free.empty()) {
+      slot = _slots.size();
+      _slots.push_back({0, 0});
+    } else {
+      slot = _free.back();
+      _free.pop_back();
+    }
+    _slots[slot].dense = _objects.size();
+    // objects live on the heap, pointers survive growth and swap-removal
+    _objects.push_back(std::make_unique<T>(key, std::forward<Args>(args)...));
+    _owners.push_back(slot);
+    _used.push_back(_frame);
+    key->data((void *)(uintptr_t)((uint64_t)_slots[slot].generation << 32 |
+                                  (slot + 1)));
+    return _objects.back().get();
+  }
+
+  T *find(const K *key) {
+    const uint64_t handle = (uintptr_t)const_cast<K *>(key)->data();
+    const uint32_t index = handle & 0xffffffff;
+    const uint32_t generation = handle >> 32;
+    if (index == 0 || index > _slots.size() ||
+        _slots[index - 1].generation != generation) {
+      return nullptr;
+    }
+    return _objects[_slots[index - 1].dense].get();
+  }
+
+  void sweep(const int &age) { sweep(age, [](T &) {}); }
+
+  template <typename F> void sweep(const int &age, const F &release) {
+    for (std::size_t dense = 0; dense < _objects.size();) {
+      if (_frame - _used[dense] <= age) {
+        ++dense;
+        continue;
+      }
+      release(*_objects[dense]);
+      const uint32_t slot = _owners[dense];
+      ++_slots[slot].generation;
+      _free.push_back(slot);
+      const std::size_t last = _objects.size() - 1;
+      if (dense != last) {
+        _objects[dense] = std::move(_objects[last]);
+        _owners[dense] = _owners[last];
+        _used[dense] = _used[last];
+        _slots[_owners[dense]].dense = dense;
+      }
+      _objects.pop_back();
+      _owners.pop_back();
+      _used.pop_back();
+    }
+    ++_frame;
+  }
+
+  Iterator begin() { return _objects.begin(); }
+  Iterator end() { return _objects.end(); }
+  std::size_t size() const { return _objects.size(); }
+
+protected:
+  class Slot {
+  public:
+    uint32_t generation;
+    uint32_t dense;
+  };
+
+  std::vector<Slot> _slots;
+  std::vector<uint32_t> _free;
+  Objects _objects;
+  std::vector<uint32_t> _owners;
+  std::vector<int> _used;
+  int _frame;
+};
+} // namespace maolan::ui
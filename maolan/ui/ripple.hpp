@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <maolan/audio/track.hpp>
+#include <maolan/ui/track.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace maolan::ui {
+class Ripple {
+public:
+  void shift(const uint64_t &at, const int64_t &amount);
+  void insert(const uint64_t &at, const uint64_t &length);
+  void remove(const uint64_t &at, const uint64_t &length);
+  void commit();
+
+protected:
+  class Lane {
+  public:
+    const Track::Clips *clips;
+    std::vector<int64_t> deltas;
+    std::size_t first;
+  };
+
+  Lane &lane(Track &track);
+
+  std::unordered_map<const audio::Track *, Lane> _lanes;
+};
+} // namespace maolan::ui
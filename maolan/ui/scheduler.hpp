@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace maolan::ui {
+class Scheduler {
+public:
+  enum Priority { Visible, Normal, Background };
+
+  using Task = std::function<bool()>;
+
+  static Scheduler *get();
+
+  void post(const Task &task, const Priority &priority = Normal);
+  void run(const double &budget);
+  std::size_t pending();
+
+protected:
+  class Entry {
+  public:
+    Task task;
+    Priority priority;
+    uint64_t order;
+
+    bool operator<(const Entry &other) const;
+  };
+
+  Scheduler();
+
+  std::priority_queue<Entry> _tasks;
+  std::mutex _mutex;
+  uint64_t _order;
+
+  static Scheduler *scheduler;
+};
+} // namespace maolan::ui
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <maolan/audio/clip.hpp>
+#include <vector>
+
+namespace maolan::ui {
+class Selection {
+public:
+  enum Mode { Replace, Add, Toggle };
+
+  static Selection *get();
+  static Mode mode();
+
+  void apply(std::vector<audio::Clip *> &clips, const Mode &mode);
+  void clear();
+  void forget(const audio::Clip *clip);
+  bool contains(const audio::Clip *clip) const;
+  bool empty() const;
+  const std::vector<audio::Clip *> &clips() const;
+
+protected:
+  Selection();
+
+  std::vector<audio::Clip *> _clips;
+  std::vector<audio::Clip *> _scratch;
+
+  static Selection *selection;
+};
+} // namespace maolan::ui
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <maolan/audio/track.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace maolan::ui {
+class Track;
+class Snap {
+public:
+  enum Source { Grid, Edges, Markers, Transients, Sources };
+
+  static Snap *get();
+
+  bool find(const double &position, const audio::Track *track,
+            const audio::Clip *const *ignore, const std::size_t &ignored,
+            double &target);
+  void invalidate();
+  void invalidate(const audio::Track *track);
+
+  bool sources[Sources];
+  bool all;
+
+protected:
+  class Point {
+  public:
+    uint64_t position;
+    const audio::Clip *clip;
+  };
+  using Points = std::vector<Point>;
+  using Lanes = std::unordered_map<const audio::Track *, Points>;
+
+  Snap();
+
+  void refresh();
+  void collect(Track &track);
+  static void nearest(const Lanes &lanes, const audio::Track *track,
+                      const bool &all, const double &position,
+                      const audio::Clip *const *ignore,
+                      const std::size_t &ignored, double &best,
+                      double &distance);
+  static void nearest(const Points &targets, const double &position,
+                      const audio::Clip *const *ignore,
+                      const std::size_t &ignored, double &best,
+                      double &distance);
+
+  Lanes _edges;
+  Lanes _transients;
+  Points _markers;
+  std::vector<uint64_t> _marks;
+  std::unordered_set<const audio::Track *> _stale;
+  std::unordered_set<const audio::Track *> _waiting;
+  uint64_t _marked;
+  uint64_t _peaks;
+  bool _dirty;
+
+  static Snap *snap;
+};
+} // namespace maolan::ui
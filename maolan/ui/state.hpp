@@ -7,7 +7,20 @@ public:
 
   static State *get();
 
-  int zoom;
+  float zoom;
+  float zoomTarget;
+  double origin;
+  bool instanced;
+  bool split;
+  bool latency;
+  bool pipelined;
+  bool parallel;
+  bool snap;
+  bool audition;
+  int ruler;
+  int fps;
+  float rate;
+  double present;
   float trackMinHeight;
   float trackMinWidth = 100;
 
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+
+namespace maolan::ui {
+class Stats {
+public:
+  static Stats *get();
+
+  void draw();
+  void frame(const double &seconds);
+  void upload(const std::size_t &bytes);
+  void stall(const double &seconds);
+  void input();
+  void latch();
+  void engine();
+  void photon();
+
+  bool shown;
+  double frameTime;
+  double stallTime;
+  std::size_t uploaded;
+  double engineLatency;
+  double photonLatency;
+
+protected:
+  Stats();
+
+  static double now();
+
+  double _stall;
+  std::size_t _uploaded;
+  double _pending;
+  double _latched;
+  std::mutex _mutex;
+
+  static Stats *stats;
+};
+} // namespace maolan::ui
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace maolan::ui {
+class TempoMap {
+public:
+  class Segment {
+  public:
+    double beat;
+    double sample;
+    double bar;
+    float spt;
+    float end;
+    int numerator;
+    int denominator;
+    bool ramp;
+  };
+
+  static TempoMap *get();
+
+  bool sync(const double &origin);
+  std::size_t add(const double &beat);
+  void remove(const std::size_t &index);
+  void set(const std::size_t &index, const float &spt, const bool &ramp,
+           const int &numerator, const int &denominator);
+  std::size_t find(const double &beat) const;
+  double beat(const double &sample) const;
+  double sample(const double &beat) const;
+  double bar(const double &beat) const;
+  float spt(const double &beat) const;
+  float reference() const;
+  uint64_t version() const;
+  const std::vector<Segment> &segments() const;
+
+protected:
+  TempoMap();
+
+  void rebuild();
+  double length(const std::size_t &index) const;
+
+  std::vector<Segment> _segments;
+  float _config;
+  float _reference;
+  uint64_t _version;
+  bool _edited;
+
+  static TempoMap *map;
+};
+} // namespace maolan::ui
@@ -0,0 +1,67 @@
+#pragma once
+#include <imgui.h>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace maolan::ui {
+class Tiles {
+public:
+  class Tile {
+  public:
+    Tile();
+    ~Tile();
+
+    ImTextureID texture;
+    ImDrawList *list;
+    ImVec2 size;
+    double from;
+    double to;
+    int used;
+    bool valid;
+    bool pending;
+  };
+
+  class Job {
+  public:
+    ImTextureID texture;
+    ImDrawList *list;
+    ImVec2 size;
+    ImVec2 scale;
+    ImVec4 background;
+    bool owned;
+  };
+
+  virtual ~Tiles();
+
+  static Tiles *get();
+  static int level(const float &zoom);
+  static float zoom(const int &level);
+
+  Tile *find(const void *owner, const int &level, const long &index,
+             const ImVec2 &size);
+  void invalidate();
+  void invalidate(const void *owner);
+  void invalidate(const void *owner, const double &from, const double &to);
+  void collect();
+  void take(std::vector<Job> &jobs, const bool &clone);
+  virtual void render(const std::vector<Job> &jobs) = 0;
+
+  static const float width;
+
+protected:
+  Tiles();
+
+  virtual ImTextureID allocate(const ImVec2 &size) = 0;
+  virtual void release(ImTextureID texture) = 0;
+
+  using Index = std::pair<int, long>;
+  std::unordered_map<const void *, std::map<Index, Tile>> _tiles;
+  std::vector<Tile *> _pending;
+  std::vector<ImTextureID> _released;
+  int _budget;
+
+  static Tiles *tiles;
+};
+} // namespace maolan::ui
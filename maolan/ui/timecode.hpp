@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace maolan::ui {
+class Timecode {
+public:
+  static std::string format(const int64_t &frame, const int64_t &nominal,
+                            const bool &drop);
+};
+} // namespace maolan::ui
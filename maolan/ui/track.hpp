@@ -1,31 +1,98 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <maolan/audio/track.hpp>
+#include <maolan/ui/primitives.hpp>
+#include <maolan/ui/registry.hpp>
 #include <maolan/ui/widgets/grid.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace maolan::ui {
+class Clip;
 class Track {
   class Labels {
   public:
-    Labels();
+    Labels(const audio::Track *track);
 
     std::string mute;
     std::string solo;
     std::string arm;
   };
 
+  class Button {
+  public:
+    ImVec2 min;
+    ImVec2 max;
+    const char *label;
+    int color;
+  };
+
 public:
+  class Span {
+  public:
+    audio::Clip *clip;
+    uint64_t start;
+    uint64_t end;
+    uint64_t reach;
+  };
+  using Clips = std::vector<Span>;
+
+  class Job {
+  public:
+    void run() const;
+
+    const Clips *clips;
+    float height;
+    Primitives::Batch *batch;
+    ImVec2 position;
+    double from;
+    float width;
+    float zoom;
+  };
+
   Track(audio::Track *track);
 
-  void draw(float &width);
+  void draw(float &width, Primitives::Batch *batch,
+            std::vector<Job> *jobs = nullptr);
+  void merge(ImDrawList *drawList);
   float height();
   void height(float h);
   audio::Track *audio();
+  const Clips *clips() const;
+  void release() const;
+
+  static void query(const Clips *clips, const double &from, const double &to,
+                    std::vector<audio::Clip *> &found);
+
+  static Registry<audio::Track, Track> registry;
 
 protected:
+  bool button(const std::string &label, const bool &on, Button &b);
+  void header(const std::string &name, const ImVec2 &minimum,
+              const ImVec2 &maximum);
+  Clip *clip(audio::Clip *c);
+  void lane(const ImVec2 &position, const float &width,
+            Primitives::Batch *batch, std::vector<Job> *jobs);
+  void schedule(std::vector<Job> *jobs, const Job &job);
+  void waves(const ImVec2 &position, const float &width);
+  void snapshot(Clips &clips);
+  static void paint(const Clips *clips, const float &height,
+                    Primitives::Batch *batch, const ImVec2 &position,
+                    const double &from, const float &width, const float &zoom);
+  static void bodies(const Clips *clips, const float &height,
+                     Primitives::Batch *batch, const ImVec2 &position,
+                     const double &from, const float &width,
+                     const float &zoom);
+
+  audio::Track *_track;
   Labels labels;
-  Grid grid;
+  Button buttons[3];
   float _height = 20;
-  audio::Track *_track;
+  std::size_t _clips = 0;
+  Clips _snapshot;
+  std::unique_ptr<ImDrawList> _list;
+  ImVec4 _spliced = {0, 0, 0, 0};
 };
 } // namespace maolan::ui
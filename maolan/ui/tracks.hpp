@@ -1,5 +1,9 @@
 #pragma once
+#include <cstdint>
+#include <imgui.h>
+#include <maolan/ui/track.hpp>
 #include <maolan/ui/widgets/timetrack.hpp>
+#include <vector>
 
 namespace maolan::ui {
 class App;
@@ -11,11 +15,26 @@ public:
   void show();
   void hide();
   void toggle();
+  void zoom(const float &target, const float &anchor);
 
 protected:
+  void animate();
+  void sync();
+  void select(const float &lanes);
+
   float width;
-  int zoom;
+  float level;
+  float anchor;
+  uint64_t tempo;
+  double bandSample;
+  float bandTop;
+  bool banding;
   bool shown;
   TimeTrack timetrack;
+  ImDrawListSplitter splitter;
+  std::vector<Track::Job> jobs;
+  std::vector<audio::Track *> rows;
+  std::vector<float> tops;
+  std::vector<audio::Clip *> found;
 };
 } // namespace maolan::ui
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <maolan/audio/clip.hpp>
+#include <maolan/audio/track.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace maolan::ui {
+class Transaction {
+public:
+  enum Kind { Move, Mute, Solo, Arm };
+
+  class Edit {
+  public:
+    Kind kind;
+    audio::Track *track;
+    audio::Clip *clip;
+    uint64_t before[2];
+    uint64_t after[2];
+  };
+
+  Transaction(const bool &transient = false);
+
+  void move(audio::Track *track, audio::Clip *clip, const uint64_t &start,
+            const uint64_t &end);
+  void mute(audio::Track *track, const bool &on);
+  void solo(audio::Track *track, const bool &on);
+  void arm(audio::Track *track, const bool &on);
+  void apply(const bool &reverse = false);
+  void restore(const std::unordered_map<
+               audio::Clip *, std::pair<uint64_t, uint64_t>> &before);
+  void shrink();
+  void forget(const audio::Clip *clip);
+  void forget(const audio::Track *track);
+  bool empty() const;
+  bool transient() const;
+  const std::vector<Edit> &edits() const;
+
+  static void commit(Transaction &&transaction);
+  static void flush();
+
+protected:
+  void flag(const Kind &kind, audio::Track *track, const bool &before,
+            const bool &after);
+  static void capture(Edit &edit);
+  static void set(const Edit &edit, const uint64_t *value);
+
+  std::vector<Edit> _edits;
+  bool _transient;
+
+  static std::vector<Transaction> pending;
+};
+} // namespace maolan::ui
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace maolan::ui {
+class Transport {
+public:
+  static Transport *get();
+  static double now();
+
+  void publish(const uint64_t &position, const double &time,
+               const double &rate);
+  void poll();
+  void reset();
+  double position(const double &at) const;
+  bool playing() const;
+
+protected:
+  Transport();
+
+  bool read(uint64_t &position, double &time, double &rate) const;
+
+  std::atomic<uint64_t> _sequence;
+  std::atomic<uint64_t> _position;
+  std::atomic<double> _time;
+  std::atomic<double> _rate;
+  std::atomic<bool> _external;
+
+  uint64_t _seen;
+  uint64_t _observed;
+  double _anchor;
+  double _stamp;
+  double _speed;
+  double _estimate;
+  double _changed;
+  double _interval;
+  int _observations;
+  bool _playing;
+
+  static Transport *transport;
+};
+} // namespace maolan::ui
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <imgui.h>
+#include <maolan/ui/peaks.hpp>
+#include <memory>
+#include <vector>
+
+namespace maolan::ui {
+class Waveforms {
+public:
+  class Wave {
+  public:
+    std::shared_ptr<Peaks> peaks;
+    ImVec2 min;
+    ImVec2 max;
+    double from;
+    float zoom;
+    float gain;
+    bool split;
+    ImU32 color;
+    ImTextureID texture;
+  };
+
+  virtual ~Waveforms();
+
+  static Waveforms *get();
+  static void draw(ImDrawList *drawList, const Wave &wave);
+  static void finish();
+
+  void target(const ImDrawData *data);
+  virtual bool fits(const Peaks &peaks) const;
+  virtual bool prepare(Wave &wave);
+  virtual void render(const Wave &wave, const ImDrawCmd &cmd) = 0;
+
+protected:
+  Waveforms();
+
+  static void callback(const ImDrawList *drawList, const ImDrawCmd *cmd);
+  static void fallback(ImDrawList *drawList, const Wave &wave);
+
+  const ImDrawData *_target;
+
+  static std::vector<Wave *> waves[2];
+  static std::vector<Wave> previous;
+  static std::size_t used;
+  static int current;
+  static Waveforms *waveforms;
+};
+} // namespace maolan::ui
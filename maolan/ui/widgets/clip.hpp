@@ -1,24 +1,63 @@
 #pragma once
+#include <cstdint>
 #include <imgui.h>
 #include <maolan/audio/clip.hpp>
+#include <maolan/audio/track.hpp>
+#include <maolan/ui/primitives.hpp>
+#include <maolan/ui/registry.hpp>
+#include <string>
+#include <vector>
 
 namespace maolan::ui {
 class Clip {
 public:
   class Labels {
   public:
-    Labels();
+    Labels(const maolan::audio::Clip *c);
 
     std::string id;
     std::string start;
     std::string end;
   };
-  Clip(maolan::audio::Clip *c);
+  Clip(maolan::audio::Clip *c, maolan::audio::Track *t);
 
   void draw(const ImVec2 &position, const float &height);
+  void wave(ImDrawList *drawList, const ImVec2 &position, const float &height);
+  bool moved(double &from, double &to);
+  void release() const;
+
+  static void paint(Primitives::Batch *batch, const ImVec2 &position,
+                    const uint64_t &start, const uint64_t &end,
+                    const double &from, const float &zoom,
+                    const float &height);
+
+  static Registry<maolan::audio::Clip, Clip> registry;
 
 protected:
+  enum Handle { None, Body, Start, End };
+
+  bool drag(const Handle &handle);
+  void group(const Handle &handle);
+  void ungroup();
+  void commit(const uint64_t &start, const uint64_t &end,
+              const bool &transient = false);
+
   maolan::audio::Clip *_clip;
+  maolan::audio::Track *_track;
   Labels labels;
+  uint64_t _start;
+  uint64_t _end;
+  uint64_t _origin[2];
+  uint64_t _ghost[2];
+  double _auditioned;
+  float _gain;
+  std::vector<maolan::audio::Clip *> _group;
+  uint64_t _lowest;
+  Handle _handle;
+  bool _auditing;
+  bool _following;
+  bool _seen;
+
+  static int64_t shift;
 };
 } // namespace maolan::ui
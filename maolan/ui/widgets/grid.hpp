@@ -1,14 +1,12 @@
 #pragma once
+#include <imgui.h>
+#include <maolan/ui/primitives.hpp>
 
 namespace maolan::ui {
-class Track;
 class Grid {
 public:
-  Grid(Track *t);
-
-  void draw();
-
-protected:
-  Track *_track;
+  static void draw(Primitives::Batch *batch, const ImVec2 &position,
+                   const double &from, const float &width, const float &zoom,
+                   const float &height);
 };
 } // namespace maolan::ui
@@ -0,0 +1,15 @@
+#pragma once
+#include <maolan/ui/markers.hpp>
+#include <vector>
+
+namespace maolan::ui {
+class MarkerTrack {
+public:
+  void draw(const float &width);
+
+protected:
+  void navigate(const double &center, const double &visible);
+
+  std::vector<const Markers::Marker *> _found;
+};
+} // namespace maolan::ui
@@ -1,12 +1,37 @@
 #pragma once
+#include <cstdint>
+#include <imgui.h>
+#include <maolan/ui/widgets/markertrack.hpp>
 #include <maolan/ui/widgets/playhead.hpp>
+#include <string>
+#include <vector>
 
 namespace maolan::ui {
 class TimeTrack {
 public:
+  enum Format { Bars, Timecode, MinSec, Samples };
+
+  class Rate {
+  public:
+    const char *name;
+    double fps;
+    int64_t nominal;
+    bool drop;
+  };
+
   void draw(const float &width);
 
+  static const Rate rates[];
+  static const int rateCount;
+
 protected:
+  void bars(ImDrawList *drawList, const ImVec2 &position, const float &right);
+  void ticks(ImDrawList *drawList, const ImVec2 &position,
+             const float &right);
+  static std::string format(const int64_t &value, const int64_t &step);
+
+  MarkerTrack _markers;
   PlayHead _playhead;
+  std::vector<int64_t> _ladder;
 };
 } // namespace maolan::ui
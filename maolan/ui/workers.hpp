@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace maolan::ui {
+class Workers {
+public:
+  ~Workers();
+
+  static Workers *get();
+
+  void post(const std::function<void()> &job);
+  void parallel(const std::size_t &count,
+                const std::function<void(std::size_t)> &job);
+  std::size_t size() const;
+
+protected:
+  Workers();
+
+  void run();
+
+  std::vector<std::thread> _threads;
+  std::deque<std::function<void()>> _jobs;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _quit;
+
+  static Workers *workers;
+};
+} // namespace maolan::ui
@@ -1,5 +1,7 @@
 #include <maolan/audio/track.hpp>
 #include <maolan/ui/app.hpp>
+#include <maolan/ui/drawcache.hpp>
+#include <maolan/ui/stats.hpp>
 #include <maolan/ui/track.hpp>
 
 using namespace maolan::ui;
@@ -8,18 +10,16 @@ const std::string App::title = "Maolan";
 
 App::App() {
   for (auto track : audio::Track::all()) {
-    Track *t = (Track *)track->data();
-    if (!t) {
-      t = new Track(track);
-      track->data(t);
-    }
+    Track::registry.get(track);
   }
 }
 
 void App::draw() {
+  DrawCache::get()->frame();
   _menu.draw(this);
   _tracks.draw();
   _playback.draw();
+  Stats::get()->draw();
 }
 
 Tracks &App::tracks() { return _tracks; }
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <maolan/ui/damage.hpp>
+
+using namespace maolan::ui;
+
+static const ImVec4 none = {0, 0, 0, 0};
+
+static bool isEmpty(const ImVec4 &r) { return r.z <= r.x || r.w <= r.y; }
+
+static ImVec4 merge(const ImVec4 &a, const ImVec4 &b) {
+  if (isEmpty(a)) {
+    return b;
+  }
+  if (isEmpty(b)) {
+    return a;
+  }
+  return {std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.z, b.z),
+          std::max(a.w, b.w)};
+}
+
+static ImVec4 intersect(const ImVec4 &a, const ImVec4 &b) {
+  return {std::max(a.x, b.x), std::max(a.y, b.y), std::min(a.z, b.z),
+          std::min(a.w, b.w)};
+}
+
+// buffer offsets are left out, the hash covers the geometry itself so a
+// command that only moved within its draw list does not count as damage
+static bool same(const ImDrawCmd &a, const ImDrawCmd &b) {
+  return a.ClipRect.x == b.ClipRect.x && a.ClipRect.y == b.ClipRect.y &&
+         a.ClipRect.z == b.ClipRect.z && a.ClipRect.w == b.ClipRect.w &&
+         a.TextureId == b.TextureId && a.ElemCount == b.ElemCount &&
+         a.UserCallback == b.UserCallback &&
+         a.UserCallbackData == b.UserCallbackData;
+}
+
+static void mix(std::size_t &seed, const void *data, const std::size_t &bytes) {
+  const auto words = (const uint32_t *)data;
+  for (std::size_t i = 0; i < bytes / sizeof(uint32_t); ++i) {
+    seed = (seed ^ words[i]) * 0x100000001b3;
+  }
+}
+
+Damage *Damage::damage = nullptr;
+
+Damage::Damage()
+    : _frames{0}, _current{none}, _display{0, 0}, _full{true} {
+  _history.fill(none);
+}
+
+Damage *Damage::get() {
+  if (damage) {
+    return damage;
+  }
+  damage = new Damage();
+  return damage;
+}
+
+void Damage::add(const ImVec2 &minimum, const ImVec2 &maximum) {
+  add(ImVec4(minimum.x, minimum.y, maximum.x, maximum.y));
+}
+
+void Damage::add(const ImVec4 &rect) { _current = merge(_current, rect); }
+
+void Damage::full() { _full = true; }
+
+void Damage::reported(ImDrawCallback callback) { _reported.insert(callback); }
+
+Damage::Command Damage::measure(const ImDrawList *drawList,
+                                const ImDrawCmd &cmd) const {
+  Command command{cmd, 0, cmd.ClipRect};
+  if (cmd.UserCallback) {
+    return command;
+  }
+  if (cmd.ElemCount == 0) {
+    command.bounds = none;
+    return command;
+  }
+  const ImDrawIdx *indices = drawList->IdxBuffer.Data + cmd.IdxOffset;
+  ImDrawIdx first = std::numeric_limits<ImDrawIdx>::max();
+  ImDrawIdx last = 0;
+  for (unsigned int i = 0; i < cmd.ElemCount; ++i) {
+    first = std::min(first, indices[i]);
+    last = std::max(last, indices[i]);
+  }
+  std::size_t hash = 0xcbf29ce484222325;
+  for (unsigned int i = 0; i < cmd.ElemCount; ++i) {
+    const uint32_t index = indices[i] - first;
+    mix(hash, &index, sizeof(index));
+  }
+  const ImDrawVert *vertices =
+      drawList->VtxBuffer.Data + cmd.VtxOffset + first;
+  const std::size_t count = last - first + 1;
+  mix(hash, vertices, count * sizeof(ImDrawVert));
+  ImVec4 bounds = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto &p = vertices[i].pos;
+    bounds = {std::min(bounds.x, p.x), std::min(bounds.y, p.y),
+              std::max(bounds.z, p.x), std::max(bounds.w, p.y)};
+  }
+  command.hash = hash;
+  command.bounds = intersect(bounds, cmd.ClipRect);
+  return command;
+}
+
+void Damage::changed(const Command &command) {
+  if (command.cmd.UserCallback && _reported.count(command.cmd.UserCallback)) {
+    return;
+  }
+  add(command.bounds);
+}
+
+void Damage::list(const ImDrawList *drawList, Snapshot &snapshot) {
+  _scratch.clear();
+  for (const auto &cmd : drawList->CmdBuffer) {
+    _scratch.push_back(measure(drawList, cmd));
+  }
+  const std::size_t common =
+      std::min(snapshot.commands.size(), _scratch.size());
+  for (std::size_t c = 0; c < common; ++c) {
+    const auto &before = snapshot.commands[c];
+    const auto &after = _scratch[c];
+    if (!before.cmd.UserCallback && same(before.cmd, after.cmd) &&
+        before.hash == after.hash) {
+      continue;
+    }
+    changed(before);
+    changed(after);
+  }
+  for (std::size_t c = common; c < snapshot.commands.size(); ++c) {
+    changed(snapshot.commands[c]);
+  }
+  for (std::size_t c = common; c < _scratch.size(); ++c) {
+    changed(_scratch[c]);
+  }
+  snapshot.commands.swap(_scratch);
+}
+
+void Damage::compute(ImDrawData *data) {
+  const int frame = ImGui::GetFrameCount();
+  std::vector<const char *> order;
+  order.reserve(data->CmdListsCount);
+  for (int i = 0; i < data->CmdListsCount; ++i) {
+    const auto drawList = data->CmdLists[i];
+    order.push_back(drawList->_OwnerName);
+    auto &snapshot = _snapshots[drawList->_OwnerName];
+    snapshot.used = frame;
+    list(drawList, snapshot);
+  }
+  for (auto it = _snapshots.begin(); it != _snapshots.end();) {
+    auto &snapshot = it->second;
+    if (snapshot.used != frame) {
+      for (const auto &command : snapshot.commands) {
+        changed(command);
+      }
+      it = _snapshots.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (order != _order || data->DisplaySize.x != _display.x ||
+      data->DisplaySize.y != _display.y) {
+    _full = true;
+  }
+  _order.swap(order);
+  _display = data->DisplaySize;
+  const ImVec4 display = {data->DisplayPos.x, data->DisplayPos.y,
+                          data->DisplayPos.x + data->DisplaySize.x,
+                          data->DisplayPos.y + data->DisplaySize.y};
+  if (_full) {
+    _current = display;
+  }
+  _current = intersect({std::floor(_current.x) - 1, std::floor(_current.y) - 1,
+                        std::ceil(_current.z) + 1, std::ceil(_current.w) + 1},
+                       display);
+  if (isEmpty(_current)) {
+    _current = none;
+  }
+}
+
+bool Damage::empty() const { return !_full && isEmpty(_current); }
+
+bool Damage::region(const int &age, ImVec4 &rect) const {
+  if (_full || age <= 0 || (std::size_t)age > _history.size() + 1 ||
+      (std::size_t)age > _frames + 1) {
+    return false;
+  }
+  rect = _current;
+  for (int i = 0; i < age - 1; ++i) {
+    rect = merge(rect, _history[i]);
+  }
+  return true;
+}
+
+void Damage::clip(ImDrawData *data, const ImVec4 &rect) const {
+  for (int i = 0; i < data->CmdListsCount; ++i) {
+    for (auto &cmd : data->CmdLists[i]->CmdBuffer) {
+      cmd.ClipRect = intersect(cmd.ClipRect, rect);
+      if (isEmpty(cmd.ClipRect) && !cmd.UserCallback) {
+        cmd.ElemCount = 0;
+      }
+    }
+  }
+}
+
+void Damage::present() {
+  for (std::size_t i = _history.size() - 1; i > 0; --i) {
+    _history[i] = _history[i - 1];
+  }
+  _history[0] = _current;
+  _current = none;
+  _full = false;
+  ++_frames;
+}
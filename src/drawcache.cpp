@@ -0,0 +1,153 @@
+#include <maolan/ui/drawcache.hpp>
+
+using namespace maolan::ui;
+
+static const int maxAge = 120;
+
+DrawCache *DrawCache::cache = nullptr;
+
+DrawCache::Entry::Entry() : origin{0, 0}, key{0}, used{0}, valid{false} {}
+
+DrawCache::DrawCache()
+    : _recording{nullptr}, _list{nullptr}, _vertex{0}, _vertices{0},
+      _indices{0}, _commands{0}, _style{0} {}
+
+DrawCache *DrawCache::get() {
+  if (cache) {
+    return cache;
+  }
+  cache = new DrawCache();
+  return cache;
+}
+
+void DrawCache::splice(ImDrawList *drawList,
+                       const ImVector<ImDrawVert> &vertices,
+                       const ImVector<ImDrawIdx> &indices,
+                       const ImVec2 &offset) {
+  splice(drawList, vertices.Data, vertices.Size, indices.Data, indices.Size,
+         offset);
+}
+
+void DrawCache::splice(ImDrawList *drawList, const ImDrawVert *vertices,
+                       const int &vertexCount, const ImDrawIdx *indices,
+                       const int &indexCount, const ImVec2 &offset) {
+  if (vertexCount == 0) {
+    return;
+  }
+  drawList->PrimReserve(indexCount, vertexCount);
+  const unsigned int base = drawList->_VtxCurrentIdx;
+  for (int i = 0; i < vertexCount; ++i) {
+    auto &v = *drawList->_VtxWritePtr++;
+    v = vertices[i];
+    v.pos.x += offset.x;
+    v.pos.y += offset.y;
+  }
+  for (int i = 0; i < indexCount; ++i) {
+    *drawList->_IdxWritePtr++ = (ImDrawIdx)(base + indices[i]);
+  }
+  drawList->_VtxCurrentIdx += vertexCount;
+}
+
+void DrawCache::splice(ImDrawList *drawList, const ImDrawList *source) {
+  const auto &commands = source->CmdBuffer;
+  for (int c = 0; c < commands.Size;) {
+    if (commands[c].UserCallback) {
+      ++c;
+      continue;
+    }
+    const unsigned int offset = commands[c].VtxOffset;
+    int last = c;
+    while (last < commands.Size && !commands[last].UserCallback &&
+           commands[last].VtxOffset == offset) {
+      ++last;
+    }
+    const unsigned int first = commands[c].IdxOffset;
+    const unsigned int end =
+        commands[last - 1].IdxOffset + commands[last - 1].ElemCount;
+    const unsigned int vertexEnd =
+        last < commands.Size && commands[last].VtxOffset != offset
+            ? commands[last].VtxOffset
+            : source->VtxBuffer.Size;
+    splice(drawList, source->VtxBuffer.Data + offset, vertexEnd - offset,
+           source->IdxBuffer.Data + first, end - first, {0, 0});
+    c = last;
+  }
+}
+
+void DrawCache::frame() {
+  const auto &style = ImGui::GetStyle();
+  _style = 0;
+  for (const auto &color : style.Colors) {
+    hash(_style, color.x);
+    hash(_style, color.y);
+    hash(_style, color.z);
+    hash(_style, color.w);
+  }
+  hash(_style, style.FramePadding.x);
+  hash(_style, style.FramePadding.y);
+  hash(_style, style.FrameRounding);
+  hash(_style, style.FrameBorderSize);
+  hash(_style, ImGui::GetFontSize());
+  hash(_style, (const void *)ImGui::GetFont());
+
+  const int frame = ImGui::GetFrameCount();
+  for (auto it = _entries.begin(); it != _entries.end();) {
+    if (frame - it->second.used > maxAge) {
+      it = _entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::size_t DrawCache::style() const { return _style; }
+
+bool DrawCache::replay(const void *owner, const int &slot,
+                       const std::size_t &key, const ImVec2 &origin) {
+  auto it = _entries.find({owner, slot});
+  if (it == _entries.end()) {
+    return false;
+  }
+  auto &entry = it->second;
+  entry.used = ImGui::GetFrameCount();
+  if (!entry.valid || entry.key != key) {
+    return false;
+  }
+  splice(ImGui::GetWindowDrawList(), entry.vertices, entry.indices,
+         {origin.x - entry.origin.x, origin.y - entry.origin.y});
+  return true;
+}
+
+void DrawCache::begin(const void *owner, const int &slot,
+                      const std::size_t &key, const ImVec2 &origin) {
+  auto &entry = _entries[{owner, slot}];
+  entry.used = ImGui::GetFrameCount();
+  entry.key = key;
+  entry.origin = origin;
+  entry.valid = false;
+  _recording = &entry;
+  _list = ImGui::GetWindowDrawList();
+  _vertex = _list->_VtxCurrentIdx;
+  _vertices = _list->VtxBuffer.Size;
+  _indices = _list->IdxBuffer.Size;
+  _commands = _list->CmdBuffer.Size;
+}
+
+void DrawCache::end() {
+  auto &entry = *_recording;
+  _recording = nullptr;
+  if (_list->CmdBuffer.Size != _commands || _list->_VtxCurrentIdx < _vertex) {
+    return;
+  }
+  const int vertices = _list->VtxBuffer.Size - _vertices;
+  const int indices = _list->IdxBuffer.Size - _indices;
+  entry.vertices.resize(vertices);
+  entry.indices.resize(indices);
+  for (int i = 0; i < vertices; ++i) {
+    entry.vertices[i] = _list->VtxBuffer[_vertices + i];
+  }
+  for (int i = 0; i < indices; ++i) {
+    entry.indices[i] = (ImDrawIdx)(_list->IdxBuffer[_indices + i] - _vertex);
+  }
+  entry.valid = true;
+}
@@ -0,0 +1,128 @@
+#include <cstddef>
+#include <imgui.h>
+#include <iostream>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+
+#include <maolan/ui/glfw/primitives.hpp>
+
+using namespace maolan::ui;
+
+static const char *vertexShader = R"(#version 330
+layout(location = 0) in vec4 rect;
+layout(location = 1) in vec4 color;
+uniform mat4 projection;
+out vec4 fragment;
+void main() {
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  fragment = color;
+  gl_Position = projection * vec4(mix(rect.xy, rect.zw, corner), 0, 1);
+}
+)";
+
+static const char *fragmentShader = R"(#version 330
+in vec4 fragment;
+out vec4 color;
+void main() { color = fragment; }
+)";
+
+static GLuint compile(const GLenum &type, const char *source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  GLint status;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[512];
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    std::cerr << "Primitives shader: " << log << '\n';
+  }
+  return shader;
+}
+
+static const std::size_t initialSize = 1 << 18;
+
+GLPrimitives::GLPrimitives() : _instances{GL_ARRAY_BUFFER, initialSize} {
+  GLuint vertex = compile(GL_VERTEX_SHADER, vertexShader);
+  GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentShader);
+  _program = glCreateProgram();
+  glAttachShader(_program, vertex);
+  glAttachShader(_program, fragment);
+  glLinkProgram(_program);
+  glDetachShader(_program, vertex);
+  glDetachShader(_program, fragment);
+  glDeleteShader(vertex);
+  glDeleteShader(fragment);
+  _projection = glGetUniformLocation(_program, "projection");
+
+  GLint lastVao;
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &lastVao);
+  glGenVertexArrays(1, &_vao);
+  glBindVertexArray(_vao);
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glVertexAttribDivisor(0, 1);
+  glVertexAttribDivisor(1, 1);
+  glBindVertexArray(lastVao);
+}
+
+GLPrimitives::~GLPrimitives() {
+  glDeleteVertexArrays(1, &_vao);
+  glDeleteProgram(_program);
+}
+
+bool GLPrimitives::supported() {
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  return gl3wIsSupported(3, 3);
+#else
+  return false;
+#endif
+}
+
+void GLPrimitives::draw(const Batch &batch, const ImDrawCmd &cmd) {
+  if (batch.rects.empty() || !_target) {
+    return;
+  }
+  const auto &position = _target->DisplayPos;
+  const auto &size = _target->DisplaySize;
+  const auto &scale = _target->FramebufferScale;
+  const float height = size.y * scale.y;
+  const ImVec4 clip = {(cmd.ClipRect.x - position.x) * scale.x,
+                       (cmd.ClipRect.y - position.y) * scale.y,
+                       (cmd.ClipRect.z - position.x) * scale.x,
+                       (cmd.ClipRect.w - position.y) * scale.y};
+  if (clip.z <= clip.x || clip.w <= clip.y) {
+    return;
+  }
+  const float L = position.x;
+  const float R = position.x + size.x;
+  const float T = position.y;
+  const float B = position.y + size.y;
+  const float ortho[4][4] = {
+      {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+      {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+      {0.0f, 0.0f, -1.0f, 0.0f},
+      {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+  };
+
+  glEnable(GL_BLEND);
+  glBlendEquation(GL_FUNC_ADD);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(clip.x, height - clip.w, clip.z - clip.x, clip.w - clip.y);
+  glUseProgram(_program);
+  glUniformMatrix4fv(_projection, 1, GL_FALSE, &ortho[0][0]);
+  glBindVertexArray(_vao);
+  const std::size_t offset = _instances.write(
+      batch.rects.data(), batch.rects.size() * sizeof(Rect), sizeof(Rect));
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Rect),
+                        (GLvoid *)(offset + offsetof(Rect, min)));
+  glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Rect),
+                        (GLvoid *)(offset + offsetof(Rect, color)));
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.rects.size());
+}
+
+void GLPrimitives::fence() { _instances.fence(); }
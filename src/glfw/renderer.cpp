@@ -0,0 +1,191 @@
+#include <cstddef>
+#include <cstdint>
+#include <imgui.h>
+#include <iostream>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+
+#include <maolan/ui/glfw/renderer.hpp>
+
+using namespace maolan::ui;
+
+static const std::size_t initialSize = 1 << 20;
+
+static const char *vertexShader = R"(#version 330
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 uv;
+layout(location = 2) in vec4 color;
+uniform mat4 projection;
+out vec2 fragmentUV;
+out vec4 fragmentColor;
+void main() {
+  fragmentUV = uv;
+  fragmentColor = color;
+  gl_Position = projection * vec4(position, 0, 1);
+}
+)";
+
+static const char *fragmentShader = R"(#version 330
+uniform sampler2D texture0;
+in vec2 fragmentUV;
+in vec4 fragmentColor;
+out vec4 color;
+void main() { color = fragmentColor * texture(texture0, fragmentUV); }
+)";
+
+static GLuint compile(const GLenum &type, const char *source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  GLint status;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[512];
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    std::cerr << "Renderer shader: " << log << '\n';
+  }
+  return shader;
+}
+
+GLRenderer::GLRenderer()
+    : _vertices{GL_ARRAY_BUFFER, initialSize},
+      _indices{GL_ELEMENT_ARRAY_BUFFER, initialSize} {
+  GLuint vertex = compile(GL_VERTEX_SHADER, vertexShader);
+  GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentShader);
+  _program = glCreateProgram();
+  glAttachShader(_program, vertex);
+  glAttachShader(_program, fragment);
+  glLinkProgram(_program);
+  glDetachShader(_program, vertex);
+  glDetachShader(_program, fragment);
+  glDeleteShader(vertex);
+  glDeleteShader(fragment);
+  _projection = glGetUniformLocation(_program, "projection");
+  _texture = glGetUniformLocation(_program, "texture0");
+  glGenVertexArrays(1, &_vao);
+}
+
+GLRenderer::~GLRenderer() {
+  glDeleteVertexArrays(1, &_vao);
+  glDeleteProgram(_program);
+}
+
+bool GLRenderer::supported() {
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  return gl3wIsSupported(3, 3);
+#else
+  return false;
+#endif
+}
+
+void GLRenderer::setup(ImDrawData *data, const int &width, const int &height) {
+  const float L = data->DisplayPos.x;
+  const float R = data->DisplayPos.x + data->DisplaySize.x;
+  const float T = data->DisplayPos.y;
+  const float B = data->DisplayPos.y + data->DisplaySize.y;
+  const float ortho[4][4] = {
+      {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+      {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+      {0.0f, 0.0f, -1.0f, 0.0f},
+      {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+  };
+  glEnable(GL_BLEND);
+  glBlendEquation(GL_FUNC_ADD);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_SCISSOR_TEST);
+  glViewport(0, 0, width, height);
+  glUseProgram(_program);
+  glUniform1i(_texture, 0);
+  glUniformMatrix4fv(_projection, 1, GL_FALSE, &ortho[0][0]);
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(_vao);
+}
+
+void GLRenderer::render(ImDrawData *data) {
+  const auto &scale = data->FramebufferScale;
+  const int width = data->DisplaySize.x * scale.x;
+  const int height = data->DisplaySize.y * scale.y;
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  GLint lastProgram, lastTexture, lastVao, lastBuffer;
+  GLint lastViewport[4];
+  glGetIntegerv(GL_CURRENT_PROGRAM, &lastProgram);
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &lastVao);
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &lastBuffer);
+  glGetIntegerv(GL_VIEWPORT, lastViewport);
+  const GLboolean lastScissor = glIsEnabled(GL_SCISSOR_TEST);
+
+  setup(data, width, height);
+  const auto &position = data->DisplayPos;
+  const GLenum type =
+      sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+  for (int n = 0; n < data->CmdListsCount; ++n) {
+    const ImDrawList *list = data->CmdLists[n];
+    const std::size_t vertices =
+        _vertices.write(list->VtxBuffer.Data,
+                        list->VtxBuffer.Size * sizeof(ImDrawVert),
+                        sizeof(ImDrawVert)) /
+        sizeof(ImDrawVert);
+    const std::size_t indices = _indices.write(
+        list->IdxBuffer.Data, list->IdxBuffer.Size * sizeof(ImDrawIdx),
+        sizeof(ImDrawIdx));
+    glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer());
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                          (GLvoid *)offsetof(ImDrawVert, pos));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                          (GLvoid *)offsetof(ImDrawVert, uv));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert),
+                          (GLvoid *)offsetof(ImDrawVert, col));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indices.buffer());
+
+    for (const auto &cmd : list->CmdBuffer) {
+      if (cmd.UserCallback) {
+        if (cmd.UserCallback == ImDrawCallback_ResetRenderState) {
+          setup(data, width, height);
+          glBindBuffer(GL_ARRAY_BUFFER, _vertices.buffer());
+          glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indices.buffer());
+        } else {
+          cmd.UserCallback(list, &cmd);
+        }
+        continue;
+      }
+      const ImVec4 clip = {(cmd.ClipRect.x - position.x) * scale.x,
+                           (cmd.ClipRect.y - position.y) * scale.y,
+                           (cmd.ClipRect.z - position.x) * scale.x,
+                           (cmd.ClipRect.w - position.y) * scale.y};
+      if (cmd.ElemCount == 0 || clip.z <= clip.x || clip.w <= clip.y ||
+          clip.x >= width || clip.y >= height) {
+        continue;
+      }
+      glScissor(clip.x, height - clip.w, clip.z - clip.x, clip.w - clip.y);
+      glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)cmd.TextureId);
+      glDrawElementsBaseVertex(
+          GL_TRIANGLES, cmd.ElemCount, type,
+          (GLvoid *)(indices + cmd.IdxOffset * sizeof(ImDrawIdx)),
+          vertices + cmd.VtxOffset);
+    }
+  }
+
+  glUseProgram(lastProgram);
+  glBindTexture(GL_TEXTURE_2D, lastTexture);
+  glBindVertexArray(lastVao);
+  glBindBuffer(GL_ARRAY_BUFFER, lastBuffer);
+  glViewport(lastViewport[0], lastViewport[1], lastViewport[2],
+             lastViewport[3]);
+  if (!lastScissor) {
+    glDisable(GL_SCISSOR_TEST);
+  }
+}
+
+void GLRenderer::fence() {
+  _vertices.fence();
+  _indices.fence();
+}
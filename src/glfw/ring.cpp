@@ -0,0 +1,126 @@
+#include <cstring>
+#include <imgui.h>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+#include <GLFW/glfw3.h>
+
+#include <maolan/ui/glfw/ring.hpp>
+#include <maolan/ui/stats.hpp>
+
+using namespace maolan::ui;
+
+static auto stats = Stats::get();
+static const GLbitfield flags =
+    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+Ring::Ring(const unsigned int &target, const std::size_t &size)
+    : _target{target}, _buffer{0}, _size{0}, _offset{0}, _region{0},
+      _mapped{nullptr}, _persistent{persistent()} {
+  _fences.fill(nullptr);
+  allocate(size);
+}
+
+Ring::~Ring() {
+  for (auto &fence : _fences) {
+    if (fence) {
+      glDeleteSync((GLsync)fence);
+    }
+  }
+  if (_mapped) {
+    glBindBuffer(_target, _buffer);
+    glUnmapBuffer(_target);
+  }
+  glDeleteBuffers(1, &_buffer);
+}
+
+bool Ring::persistent() {
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  return gl3wIsSupported(4, 4);
+#else
+  return false;
+#endif
+}
+
+void Ring::allocate(const std::size_t &size) {
+  for (auto &fence : _fences) {
+    if (fence) {
+      glDeleteSync((GLsync)fence);
+      fence = nullptr;
+    }
+  }
+  if (_buffer) {
+    if (_mapped) {
+      glBindBuffer(_target, _buffer);
+      glUnmapBuffer(_target);
+      _mapped = nullptr;
+    }
+    glDeleteBuffers(1, &_buffer);
+  }
+  _size = size;
+  _offset = 0;
+  _region = 0;
+  glGenBuffers(1, &_buffer);
+  glBindBuffer(_target, _buffer);
+  if (_persistent) {
+    glBufferStorage(_target, _size * regions, nullptr, flags);
+    _mapped = (unsigned char *)glMapBufferRange(_target, 0, _size * regions,
+                                                flags);
+  } else {
+    glBufferData(_target, _size, nullptr, GL_STREAM_DRAW);
+  }
+}
+
+std::size_t Ring::write(const void *data, const std::size_t &bytes,
+                        const std::size_t &alignment) {
+  // align the absolute buffer offset, region strides need not be multiples
+  std::size_t base = _persistent ? _region * _size : 0;
+  std::size_t offset =
+      (base + _offset + alignment - 1) / alignment * alignment - base;
+  if (offset + bytes > _size) {
+    std::size_t size = _size * 2;
+    while (size < bytes * 2) {
+      size *= 2;
+    }
+    allocate(size);
+    base = 0;
+    offset = 0;
+  }
+  glBindBuffer(_target, _buffer);
+  if (_persistent) {
+    std::memcpy(_mapped + base + offset, data, bytes);
+  } else {
+    if (offset == 0) {
+      glBufferData(_target, _size, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(_target, offset, bytes, data);
+  }
+  _offset = offset + bytes;
+  stats->upload(bytes);
+  return base + offset;
+}
+
+void Ring::fence() {
+  if (_persistent) {
+    _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _region = (_region + 1) % regions;
+    wait(_region);
+  }
+  _offset = 0;
+}
+
+void Ring::wait(const std::size_t &region) {
+  auto fence = (GLsync)_fences[region];
+  if (!fence) {
+    return;
+  }
+  const double start = glfwGetTime();
+  while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) ==
+         GL_TIMEOUT_EXPIRED)
+    ;
+  stats->stall(glfwGetTime() - start);
+  glDeleteSync(fence);
+  _fences[region] = nullptr;
+}
+
+unsigned int Ring::buffer() const { return _buffer; }
@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <imgui.h>
+#include <imgui_impl_opengl3.h>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+
+#include <maolan/ui/glfw/renderer.hpp>
+#include <maolan/ui/glfw/tiles.hpp>
+#include <maolan/ui/primitives.hpp>
+
+using namespace maolan::ui;
+
+GLTiles::GLTiles(GLRenderer *renderer) : _renderer{renderer} {
+  glGenFramebuffers(1, &_framebuffer);
+}
+
+GLTiles::~GLTiles() {
+  for (auto &[owner, owned] : _tiles) {
+    for (auto &[index, tile] : owned) {
+      if (tile.texture) {
+        release(tile.texture);
+        tile.texture = nullptr;
+      }
+    }
+  }
+  glDeleteFramebuffers(1, &_framebuffer);
+}
+
+ImTextureID GLTiles::allocate(const ImVec2 &size) {
+  const auto &scale = ImGui::GetIO().DisplayFramebufferScale;
+  GLint last;
+  GLuint texture;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &last);
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x * scale.x, size.y * scale.y,
+               0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindTexture(GL_TEXTURE_2D, last);
+  return (ImTextureID)(intptr_t)texture;
+}
+
+void GLTiles::release(ImTextureID texture) {
+  GLuint t = (GLuint)(intptr_t)texture;
+  glDeleteTextures(1, &t);
+}
+
+void GLTiles::render(const std::vector<Job> &jobs) {
+  if (jobs.empty()) {
+    return;
+  }
+  auto primitives = Primitives::get();
+  GLint last;
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &last);
+  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+  for (const auto &job : jobs) {
+    const auto &scale = job.scale;
+    const auto &background = job.background;
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           (GLuint)(intptr_t)job.texture, 0);
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, job.size.x * scale.x, job.size.y * scale.y);
+    glClearColor(background.x, background.y, background.z, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    ImDrawList *list = job.list;
+    ImDrawData data;
+    data.Valid = true;
+    data.CmdLists = &list;
+    data.CmdListsCount = 1;
+    data.TotalVtxCount = list->VtxBuffer.Size;
+    data.TotalIdxCount = list->IdxBuffer.Size;
+    data.DisplayPos = {0, 0};
+    data.DisplaySize = job.size;
+    data.FramebufferScale = scale;
+    if (primitives) {
+      primitives->target(&data);
+    }
+    if (_renderer) {
+      _renderer->render(&data);
+    } else {
+      ImGui_ImplOpenGL3_RenderDrawData(&data);
+    }
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, last);
+}
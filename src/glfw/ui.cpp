@@ -1,27 +1,57 @@
+#include <algorithm>
+#include <cmath>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <iostream>
 #include <string>
+#include <thread>
 #define GL_SILENCE_DEPRECATION
 #if defined(IMGUI_IMPL_OPENGL_ES2)
 #include <GLES2/gl2.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
 #endif
 #include <GLFW/glfw3.h>
+#if defined(GLFW_EXPOSE_NATIVE_GLX)
+#include <GLFW/glfw3native.h>
+#include <cstring>
+#ifndef GLX_BACK_BUFFER_AGE_EXT
+#define GLX_BACK_BUFFER_AGE_EXT 0x20F4
+#endif
+#endif
 
 #include <maolan/ui/app.hpp>
+#include <maolan/ui/damage.hpp>
+#include <maolan/ui/glfw/primitives.hpp>
+#include <maolan/ui/glfw/renderer.hpp>
+#include <maolan/ui/glfw/tiles.hpp>
+#include <maolan/ui/glfw/uploads.hpp>
+#include <maolan/ui/glfw/waveforms.hpp>
 #include <maolan/ui/glfw/ui.hpp>
+#include <maolan/ui/scheduler.hpp>
 #include <maolan/ui/state.hpp>
+#include <maolan/ui/stats.hpp>
+#include <maolan/ui/transport.hpp>
 
 using namespace maolan::ui;
 
 static auto state = State::get();
+static auto damage = Damage::get();
+static auto stats = Stats::get();
+static auto scheduler = Scheduler::get();
+static const double taskBudget = 0.002;
+static const double taskMinimum = 0.00025;
+static const double latencyMargin = 0.001;
 
 static void glfw_error_callback(int error, const char *description) {
   std::cerr << "Glfw Error " << error << ": " << description << '\n';
 }
 
-GLFW::GLFW(const std::string &title) {
+GLFW::GLFW(const std::string &title)
+    : _shared{nullptr}, _period{1.0 / 60}, _build{0}, _submit{0},
+      _deadline{0}, _vsync{0}, _submitted{0}, _bufferAge{false},
+      _presented{true}, _busy{false}, _quit{false} {
   glfwSetErrorCallback(glfw_error_callback);
   if (!glfwInit()) {
     exit(1);
@@ -34,29 +64,51 @@ GLFW::GLFW(const std::string &title) {
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
   glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-#elif defined(__APPLE__)
-  // GL 3.2 + GLSL 150
-  const char *glsl_version = "#version 150";
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
-  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // 3.2+ only
-  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);           // Required on Mac
 #else
-  // GL 3.0 + GLSL 130
-  const char *glsl_version = "#version 130";
+  // GL 3.3 core + GLSL 150, the batched renderers, primitives and waveforms
+  // need 3.3 and compat profiles (Mesa, macOS) stop at 3.0/2.1
+  const char *glsl_version = "#version 150";
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-  // glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+
-  // only glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // 3.0+ only
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE); // Required on Mac
 #endif
 
   // Create window with graphics context
   _window = glfwCreateWindow(1280, 720, title.data(), nullptr, nullptr);
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(__APPLE__)
+  if (_window == nullptr) {
+    // GL 3.0 + GLSL 130, the 3.3 renderers then switch themselves off
+    glsl_version = "#version 130";
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_ANY_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_FALSE);
+    _window = glfwCreateWindow(1280, 720, title.data(), nullptr, nullptr);
+  }
+#endif
   if (_window == nullptr) {
     exit(1);
   }
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  _shared = glfwCreateWindow(1, 1, "", nullptr, _window);
   glfwMakeContextCurrent(_window);
   glfwSwapInterval(1); // Enable vsync
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  if (gl3wInit() != 0) {
+    exit(1);
+  }
+#endif
+  auto mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+  if (mode && mode->refreshRate > 0) {
+    _period = 1.0 / mode->refreshRate;
+  }
+#if defined(GLFW_EXPOSE_NATIVE_GLX)
+  auto display = glfwGetX11Display();
+  if (display) {
+    auto extensions = glXQueryExtensionsString(display, DefaultScreen(display));
+    _bufferAge = extensions && std::strstr(extensions, "GLX_EXT_buffer_age");
+  }
+#endif
 
   // Setup Dear ImGui context
   IMGUI_CHECKVERSION();
@@ -70,46 +122,293 @@ GLFW::GLFW(const std::string &title) {
   ImGui::StyleColorsDark();
   // ImGui::StyleColorsLight();
 
+  glfwSetCursorPosCallback(_window, [](GLFWwindow *, double, double) {
+    stats->input();
+  });
+  glfwSetMouseButtonCallback(_window, [](GLFWwindow *, int, int, int) {
+    stats->input();
+  });
+  glfwSetScrollCallback(_window, [](GLFWwindow *, double, double) {
+    stats->input();
+  });
+  glfwSetKeyCallback(_window, [](GLFWwindow *, int, int, int, int) {
+    stats->input();
+  });
   ImGui_ImplGlfw_InitForOpenGL(_window, true);
   ImGui_ImplOpenGL3_Init(glsl_version);
+  _renderer = GLRenderer::supported() ? new GLRenderer() : nullptr;
+  _tiles = new GLTiles(_renderer);
+  _primitives = GLPrimitives::supported() ? new GLPrimitives() : nullptr;
+  _uploads = GLUploads::supported() ? new GLUploads() : nullptr;
+  _waveforms =
+      GLWaveforms::supported() ? new GLWaveforms(_uploads) : nullptr;
 }
 
 void GLFW::prepare() {
   glfwPollEvents();
+  stats->latch();
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
 }
 
 void GLFW::render() {
+  build(_frame, false);
+  submit(_frame);
+}
+
+void GLFW::build(Frame &frame, const bool &clone) {
   ImGui::Render();
-  int display_w, display_h;
-  glfwGetFramebufferSize(_window, &display_w, &display_h);
-  glViewport(0, 0, display_w, display_h);
-  // glClearColor(clear_color->x, clear_color->y, clear_color->z,
-  // clear_color->w);
+  auto data = ImGui::GetDrawData();
+  Primitives::finish();
+  Waveforms::finish();
+  _tiles->take(frame.tiles, clone);
+  damage->compute(data);
+  frame.presented = !damage->empty();
+  frame.partial = false;
+  if (frame.presented) {
+    // the buffer age query needs the drawable current on this thread, which
+    // the render thread holds while pipelined, so those frames redraw fully
+    frame.partial = !clone && damage->region(age(), frame.rect);
+    damage->present();
+  }
+  _presented = frame.presented;
+  _tiles->collect();
+  if (_waveforms) {
+    _waveforms->collect();
+  }
+  glfwGetFramebufferSize(_window, &frame.width, &frame.height);
+  frame.data = *data;
+  frame.fence = nullptr;
+  if (clone) {
+    frame.lists.resize(data->CmdListsCount);
+    for (int i = 0; i < data->CmdListsCount; ++i) {
+      frame.lists[i] = data->CmdLists[i]->CloneOutput();
+    }
+    frame.data.CmdLists = frame.lists.data();
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+  }
+}
+
+void GLFW::submit(Frame &frame) {
+  if (frame.fence) {
+    glWaitSync((GLsync)frame.fence, 0, GL_TIMEOUT_IGNORED);
+    glDeleteSync((GLsync)frame.fence);
+    frame.fence = nullptr;
+  }
+  if (_uploads) {
+    _uploads->pump();
+  }
+  _tiles->render(frame.tiles);
+  if (!frame.presented) {
+    _submitted = glfwGetTime();
+    release(frame);
+    return;
+  }
+  auto data = &frame.data;
+  glViewport(0, 0, frame.width, frame.height);
+  glClearColor(0, 0, 0, 0);
+  if (frame.partial) {
+    const auto &rect = frame.rect;
+    const auto &position = data->DisplayPos;
+    const auto &scale = data->FramebufferScale;
+    damage->clip(data, rect);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor((rect.x - position.x) * scale.x,
+              frame.height - (rect.w - position.y) * scale.y,
+              (rect.z - rect.x) * scale.x, (rect.w - rect.y) * scale.y);
+  }
   glClear(GL_COLOR_BUFFER_BIT);
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  if (_primitives) {
+    _primitives->target(data);
+  }
+  if (_waveforms) {
+    _waveforms->target(data);
+  }
+  if (_renderer) {
+    _renderer->render(data);
+  } else {
+    ImGui_ImplOpenGL3_RenderDrawData(data);
+  }
+  glDisable(GL_SCISSOR_TEST);
+  _submitted = glfwGetTime();
   glfwSwapBuffers(_window);
+  _vsync = glfwGetTime();
+  stats->photon();
+  if (_renderer) {
+    _renderer->fence();
+  }
+  if (_primitives) {
+    _primitives->fence();
+  }
+  release(frame);
+}
+
+void GLFW::release(Frame &frame) {
+  for (auto list : frame.lists) {
+    IM_DELETE(list);
+  }
+  frame.lists.clear();
+  for (const auto &job : frame.tiles) {
+    if (job.owned) {
+      IM_DELETE(job.list);
+    }
+  }
+  frame.tiles.clear();
+}
+
+void GLFW::pipeline(const bool &on) {
+  if (on == _thread.joinable() || !_shared) {
+    return;
+  }
+  if (on) {
+    glfwMakeContextCurrent(_shared);
+    _quit = false;
+    _thread = std::thread(&GLFW::loop, this);
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return !_busy; });
+    _quit = true;
+  }
+  _condition.notify_all();
+  _thread.join();
+  glfwMakeContextCurrent(_window);
+}
+
+void GLFW::loop() {
+  glfwMakeContextCurrent(_window);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] { return _busy || _quit; });
+      if (_quit) {
+        break;
+      }
+    }
+    submit(_frame);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _busy = false;
+    }
+    _condition.notify_all();
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
+void GLFW::idle() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _condition.wait(lock, [this] { return !_busy; });
+}
+
+int GLFW::age() {
+#if defined(GLFW_EXPOSE_NATIVE_GLX)
+  if (_bufferAge) {
+    unsigned int age = 0;
+    glXQueryDrawable(glfwGetX11Display(), glfwGetGLXWindow(_window),
+                     GLX_BACK_BUFFER_AGE_EXT, &age);
+    return age;
+  }
+#endif
+  return 0;
 }
 
 void GLFW::run(App *app) {
   prepare();
+  expect(glfwGetTime());
   app->draw();
   render();
   state->trackMinHeight = 2 * ImGui::GetTextLineHeightWithSpacing() +
                           ImGui::GetStyle().ItemInnerSpacing.y;
   while (!glfwWindowShouldClose(_window)) {
+    pipeline(state->pipelined);
+    if (state->latency) {
+      wait();
+    }
+    const double start = glfwGetTime();
     prepare();
+    expect(start);
     app->draw();
-    render();
+    double built;
+    if (_thread.joinable()) {
+      idle();
+      build(_frame, true);
+      built = glfwGetTime() - start;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _busy = true;
+      }
+      _condition.notify_all();
+      // the render thread presents this frame, the next one must start in
+      // time to be built before the vsync after it
+      tasks(_deadline + _period - _build);
+    } else {
+      build(_frame, false);
+      built = glfwGetTime() - start;
+      // run tasks in the slack the swap would otherwise block through
+      tasks(_deadline - _submit);
+      const double submitting = glfwGetTime();
+      submit(_frame);
+      const double submitted = _submitted - submitting;
+      _submit = submitted > _submit ? submitted
+                                    : _submit + (submitted - _submit) * 0.1;
+      built += submitted;
+    }
+    _build = built > _build ? built : _build + (built - _build) * 0.1;
+    stats->frame(glfwGetTime() - start);
+    if (!_presented && scheduler->pending() == 0) {
+      glfwWaitEventsTimeout(_period);
+    }
+  }
+  pipeline(false);
+}
+
+void GLFW::expect(const double &start) {
+  const double ready = start + _build;
+  double vsync = _vsync;
+  if (vsync < ready) {
+    vsync += std::ceil((ready - vsync) / _period) * _period;
+  }
+  if (_thread.joinable()) {
+    vsync += _period;
+  }
+  _deadline = vsync;
+  state->present = Transport::now() + (vsync - glfwGetTime());
+}
+
+void GLFW::tasks(const double &deadline) {
+  const double left = deadline - latencyMargin - glfwGetTime();
+  scheduler->run(std::max(taskMinimum, std::min(taskBudget, left)));
+}
+
+void GLFW::wait() {
+  const double now = glfwGetTime();
+  double vsync = _vsync;
+  while (vsync + _period < now) {
+    vsync += _period;
+  }
+  const double wake = vsync + _period - _build - latencyMargin;
+  // wake on every event so the input callbacks stamp arrival, not the poll
+  for (double left = wake - now; left > 0; left = wake - glfwGetTime()) {
+    glfwWaitEventsTimeout(left);
   }
 }
 
 GLFW::~GLFW() {
+  pipeline(false);
+  delete _waveforms;
+  delete _uploads;
+  delete _primitives;
+  delete _tiles;
+  delete _renderer;
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
+  if (_shared) {
+    glfwDestroyWindow(_shared);
+  }
   glfwDestroyWindow(_window);
   glfwTerminate();
 }
@@ -0,0 +1,98 @@
+#include <imgui.h>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+
+#include <maolan/ui/glfw/uploads.hpp>
+#include <vector>
+
+using namespace maolan::ui;
+
+GLUploads::GLUploads(const std::size_t &budget)
+    : _ring{GL_PIXEL_UNPACK_BUFFER, budget}, _budget{budget}, _posted{0},
+      _completed{0} {
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+GLUploads::~GLUploads() {
+  for (auto &fence : _fences) {
+    glDeleteSync((GLsync)fence.second);
+  }
+}
+
+bool GLUploads::supported() {
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  return gl3wIsSupported(3, 2);
+#else
+  return false;
+#endif
+}
+
+uint64_t GLUploads::post(const Upload &upload) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _queue.push_back(upload);
+  _queue.back().ticket = ++_posted;
+  return _posted;
+}
+
+bool GLUploads::ready(const uint64_t &ticket) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return ticket <= _completed;
+}
+
+std::size_t GLUploads::pending() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _queue.size();
+}
+
+void GLUploads::poll() {
+  while (!_fences.empty()) {
+    auto fence = (GLsync)_fences.front().second;
+    const auto status = glClientWaitSync(fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _completed = _fences.front().first;
+    }
+    glDeleteSync(fence);
+    _fences.pop_front();
+  }
+}
+
+void GLUploads::pump() {
+  poll();
+  static std::vector<Upload> batch;
+  batch.clear();
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t spent = 0;
+    while (!_queue.empty() &&
+           (spent == 0 || spent + _queue.front().bytes <= _budget)) {
+      spent += _queue.front().bytes;
+      batch.push_back(std::move(_queue.front()));
+      _queue.pop_front();
+    }
+  }
+  if (batch.empty()) {
+    return;
+  }
+  GLint lastTexture;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  for (const auto &upload : batch) {
+    const std::size_t offset = _ring.write(upload.pixels, upload.bytes, 16);
+    glBindTexture(GL_TEXTURE_2D, upload.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, upload.x, upload.y, upload.width,
+                    upload.height, upload.format, upload.type,
+                    (const GLvoid *)offset);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, lastTexture);
+  _fences.emplace_back(batch.back().ticket,
+                       glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  _ring.fence();
+  batch.clear();
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <imgui.h>
+#include <iostream>
+#include <vector>
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#endif
+
+#include <maolan/ui/glfw/uploads.hpp>
+#include <maolan/ui/glfw/waveforms.hpp>
+
+using namespace maolan::ui;
+
+static const int textureWidth = 4096;
+static const int maxLevels = 32;
+static const std::size_t bandBytes = 1 << 20;
+
+static const char *vertexShader = R"(#version 330
+uniform mat4 projection;
+uniform vec4 rect;
+out vec2 position;
+void main() {
+  vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+  position = mix(rect.xy, rect.zw, corner);
+  gl_Position = projection * vec4(position, 0, 1);
+}
+)";
+
+static const char *fragmentShader = R"(#version 330
+uniform sampler2D peaks;
+uniform vec4 rect;
+uniform int origin;
+uniform float offset;
+uniform float zoom;
+uniform float gain;
+uniform float base;
+uniform int channels;
+uniform int split;
+uniform int stride;
+uniform int levels;
+uniform int offsets[32];
+uniform int sizes[32];
+uniform vec4 tint;
+in vec2 position;
+out vec4 color;
+vec2 fetch(int channel, int level, int block) {
+  int i = channel * stride + offsets[level] + block;
+  return texelFetch(peaks, ivec2(i % 4096, i / 4096), 0).rg;
+}
+void main() {
+  int level = clamp(int(log2(max(zoom / base, 1.0))), 0, levels - 1);
+  float size = base * exp2(float(level));
+  int whole = origin >> level;
+  float start = float(origin - (whole << level)) * base + offset +
+                floor(position.x - rect.x) * zoom;
+  int first = whole + int(start / size);
+  int last = min(max(first + 1, whole + int(ceil((start + zoom) / size))),
+                 sizes[level]);
+  if (first >= last) {
+    discard;
+  }
+  int lanes = split != 0 ? channels : 1;
+  float height = (rect.w - rect.y) / float(lanes);
+  int lane = min(int((position.y - rect.y) / height), lanes - 1);
+  float half = 0.5 * height;
+  float center = rect.y + float(lane) * height + half;
+  float value = (center - position.y) / (half * gain);
+  float pixel = 0.5 / (half * gain);
+  vec2 range = vec2(1e9, -1e9);
+  int low = split != 0 ? lane : 0;
+  int high = split != 0 ? lane + 1 : channels;
+  for (int c = low; c < high; ++c) {
+    for (int b = first; b < last && b < first + 4; ++b) {
+      vec2 p = fetch(c, level, b);
+      range = vec2(min(range.x, p.x), max(range.y, p.y));
+    }
+  }
+  if (value < range.x - pixel || value > range.y + pixel) {
+    discard;
+  }
+  color = tint;
+}
+)";
+
+static GLuint compile(const GLenum &type, const char *source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  GLint status;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[512];
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    std::cerr << "Waveform shader: " << log << '\n';
+  }
+  return shader;
+}
+
+GLWaveforms::GLWaveforms(GLUploads *uploads)
+    : _uploads{uploads}, _frame{0} {
+  GLuint vertex = compile(GL_VERTEX_SHADER, vertexShader);
+  GLuint fragment = compile(GL_FRAGMENT_SHADER, fragmentShader);
+  _program = glCreateProgram();
+  glAttachShader(_program, vertex);
+  glAttachShader(_program, fragment);
+  glLinkProgram(_program);
+  glDetachShader(_program, vertex);
+  glDetachShader(_program, fragment);
+  glDeleteShader(vertex);
+  glDeleteShader(fragment);
+  _projection = glGetUniformLocation(_program, "projection");
+  _rect = glGetUniformLocation(_program, "rect");
+  _origin = glGetUniformLocation(_program, "origin");
+  _offset = glGetUniformLocation(_program, "offset");
+  _zoom = glGetUniformLocation(_program, "zoom");
+  _gain = glGetUniformLocation(_program, "gain");
+  _base = glGetUniformLocation(_program, "base");
+  _channels = glGetUniformLocation(_program, "channels");
+  _split = glGetUniformLocation(_program, "split");
+  _stride = glGetUniformLocation(_program, "stride");
+  _levels = glGetUniformLocation(_program, "levels");
+  _offsets = glGetUniformLocation(_program, "offsets");
+  _sizes = glGetUniformLocation(_program, "sizes");
+  _tint = glGetUniformLocation(_program, "tint");
+  glGenVertexArrays(1, &_vao);
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &_maxSize);
+}
+
+GLWaveforms::~GLWaveforms() {
+  for (auto &it : _textures) {
+    glDeleteTextures(1, &it.second.id);
+  }
+  glDeleteVertexArrays(1, &_vao);
+  glDeleteProgram(_program);
+}
+
+bool GLWaveforms::supported() {
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+  return gl3wIsSupported(3, 3);
+#else
+  return false;
+#endif
+}
+
+bool GLWaveforms::fits(const Peaks &peaks) const {
+  const int rows = (peaks.data.size() + textureWidth - 1) / textureWidth;
+  return textureWidth <= _maxSize && rows <= _maxSize;
+}
+
+bool GLWaveforms::prepare(Wave &wave) {
+  const auto &peaks = wave.peaks;
+  auto it = _textures.find(peaks.get());
+  if (it != _textures.end()) {
+    it->second.used = _frame;
+    wave.texture = (ImTextureID)(intptr_t)it->second.id;
+    return !_uploads || _uploads->ready(it->second.ticket);
+  }
+  const int count = peaks->data.size();
+  const int rows = (count + textureWidth - 1) / textureWidth;
+  GLint lastTexture;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  GLuint id;
+  glGenTextures(1, &id);
+  glBindTexture(GL_TEXTURE_2D, id);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, textureWidth, rows, 0, GL_RG,
+               GL_FLOAT, nullptr);
+  const std::size_t row = textureWidth * sizeof(ImVec2);
+  const int band = _uploads ? std::max<int>(1, bandBytes / row) : rows;
+  uint64_t ticket = 0;
+  for (int y = 0; y < rows; y += band) {
+    const int first = y * textureWidth;
+    const int last = std::min(count, (y + band) * textureWidth);
+    const int full = (last - first) / textureWidth;
+    GLUploads::Upload upload;
+    upload.owner = peaks;
+    upload.texture = id;
+    upload.x = 0;
+    upload.y = y;
+    upload.width = full > 0 ? textureWidth : last - first;
+    upload.height = full > 0 ? full : 1;
+    upload.format = GL_RG;
+    upload.type = GL_FLOAT;
+    upload.pixels = peaks->data.data() + first;
+    upload.bytes = upload.width * upload.height * sizeof(ImVec2);
+    if (_uploads) {
+      ticket = _uploads->post(upload);
+    } else {
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, upload.x, upload.y, upload.width,
+                      upload.height, upload.format, upload.type,
+                      upload.pixels);
+    }
+    if (full > 0 && first + full * textureWidth < last) {
+      upload.y = y + full;
+      upload.width = last - first - full * textureWidth;
+      upload.height = 1;
+      upload.pixels = peaks->data.data() + first + full * textureWidth;
+      upload.bytes = upload.width * sizeof(ImVec2);
+      if (_uploads) {
+        ticket = _uploads->post(upload);
+      } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, upload.x, upload.y, upload.width,
+                        upload.height, upload.format, upload.type,
+                        upload.pixels);
+      }
+    }
+  }
+  glBindTexture(GL_TEXTURE_2D, lastTexture);
+  _textures[peaks.get()] = {peaks, id, _frame, ticket};
+  wave.texture = (ImTextureID)(intptr_t)id;
+  return !_uploads;
+}
+
+void GLWaveforms::render(const Wave &wave, const ImDrawCmd &cmd) {
+  const auto &peaks = *wave.peaks;
+  if (!_target || peaks.sizes.empty() || peaks.sizes.size() > maxLevels) {
+    return;
+  }
+  const auto &position = _target->DisplayPos;
+  const auto &size = _target->DisplaySize;
+  const auto &scale = _target->FramebufferScale;
+  const float height = size.y * scale.y;
+  const ImVec4 clip = {(cmd.ClipRect.x - position.x) * scale.x,
+                       (cmd.ClipRect.y - position.y) * scale.y,
+                       (cmd.ClipRect.z - position.x) * scale.x,
+                       (cmd.ClipRect.w - position.y) * scale.y};
+  if (clip.z <= clip.x || clip.w <= clip.y) {
+    return;
+  }
+  const float L = position.x;
+  const float R = position.x + size.x;
+  const float T = position.y;
+  const float B = position.y + size.y;
+  const float ortho[4][4] = {
+      {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+      {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+      {0.0f, 0.0f, -1.0f, 0.0f},
+      {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+  };
+  static std::vector<GLint> offsets, sizes;
+  offsets.assign(peaks.offsets.begin(), peaks.offsets.end());
+  sizes.assign(peaks.sizes.begin(), peaks.sizes.end());
+  const auto tint = ImGui::ColorConvertU32ToFloat4(wave.color);
+
+  glEnable(GL_BLEND);
+  glBlendEquation(GL_FUNC_ADD);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(clip.x, height - clip.w, clip.z - clip.x, clip.w - clip.y);
+  glUseProgram(_program);
+  glUniformMatrix4fv(_projection, 1, GL_FALSE, &ortho[0][0]);
+  glUniform4f(_rect, wave.min.x, wave.min.y, wave.max.x, wave.max.y);
+  // a float sample position runs out of precision past 2^24 samples, so the
+  // origin goes in as whole level 0 blocks plus the samples left over
+  const double block = std::floor(wave.from / Peaks::base);
+  glUniform1i(_origin, GLint(block));
+  glUniform1f(_offset, float(wave.from - block * Peaks::base));
+  glUniform1f(_zoom, wave.zoom);
+  glUniform1f(_gain, wave.gain);
+  glUniform1f(_base, Peaks::base);
+  glUniform1i(_channels, peaks.channels);
+  glUniform1i(_split, wave.split);
+  glUniform1i(_stride, peaks.stride);
+  glUniform1i(_levels, sizes.size());
+  glUniform1iv(_offsets, offsets.size(), offsets.data());
+  glUniform1iv(_sizes, sizes.size(), sizes.data());
+  glUniform4f(_tint, tint.x, tint.y, tint.z, tint.w);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)wave.texture);
+  glBindVertexArray(_vao);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void GLWaveforms::collect() {
+  for (auto it = _textures.begin(); it != _textures.end();) {
+    const bool uploaded = !_uploads || _uploads->ready(it->second.ticket);
+    if (uploaded && _frame - it->second.used > 120) {
+      glDeleteTextures(1, &it->second.id);
+      it = _textures.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ++_frame;
+}
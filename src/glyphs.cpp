@@ -0,0 +1,102 @@
+#include <maolan/ui/drawcache.hpp>
+#include <maolan/ui/glyphs.hpp>
+
+using namespace maolan::ui;
+
+static const int maxAge = 120;
+
+Glyphs *Glyphs::glyphs = nullptr;
+
+bool Glyphs::Key::operator==(const Key &other) const {
+  return format == other.format && value == other.value &&
+         extra == other.extra;
+}
+
+std::size_t Glyphs::Hash::operator()(const Key &key) const {
+  std::size_t seed = 0;
+  DrawCache::hash(seed, key.format);
+  DrawCache::hash(seed, key.value);
+  DrawCache::hash(seed, key.extra);
+  return seed;
+}
+
+Glyphs::Glyphs() : _font{nullptr}, _size{0}, _swept{0} {}
+
+Glyphs *Glyphs::get() {
+  if (glyphs) {
+    return glyphs;
+  }
+  glyphs = new Glyphs();
+  return glyphs;
+}
+
+const Glyphs::Run *Glyphs::find(const Key &key) {
+  const ImFont *font = ImGui::GetFont();
+  const float size = ImGui::GetFontSize();
+  if (font != _font || size != _size) {
+    _runs.clear();
+    _font = font;
+    _size = size;
+    return nullptr;
+  }
+  auto it = _runs.find(key);
+  if (it == _runs.end()) {
+    return nullptr;
+  }
+  it->second.used = ImGui::GetFrameCount();
+  return &it->second;
+}
+
+const Glyphs::Run *Glyphs::shape(const Key &key, const std::string &text) {
+  auto &run = _runs[key];
+  run.quads.clear();
+  run.uvs.clear();
+  run.used = ImGui::GetFrameCount();
+  const float scale = _size / _font->FontSize;
+  float x = 0;
+  for (const char c : text) {
+    const ImFontGlyph *glyph = _font->FindGlyph((ImWchar)c);
+    if (!glyph) {
+      continue;
+    }
+    if (glyph->Visible) {
+      run.quads.push_back({x + glyph->X0 * scale, glyph->Y0 * scale,
+                           x + glyph->X1 * scale, glyph->Y1 * scale});
+      run.uvs.push_back({glyph->U0, glyph->V0, glyph->U1, glyph->V1});
+    }
+    x += glyph->AdvanceX * scale;
+  }
+  run.width = x;
+  return &run;
+}
+
+void Glyphs::draw(ImDrawList *drawList, const Run *run,
+                  const ImVec2 &position, const ImU32 &color) {
+  const int count = run->quads.size();
+  if (count == 0) {
+    return;
+  }
+  drawList->PrimReserve(count * 6, count * 4);
+  for (int i = 0; i < count; ++i) {
+    const auto &q = run->quads[i];
+    const auto &uv = run->uvs[i];
+    drawList->PrimRectUV({position.x + q.x, position.y + q.y},
+                         {position.x + q.z, position.y + q.w}, {uv.x, uv.y},
+                         {uv.z, uv.w}, color);
+  }
+}
+
+void Glyphs::sweep() {
+  const int frame = ImGui::GetFrameCount();
+  if (frame - _swept < maxAge) {
+    return;
+  }
+  _swept = frame;
+  for (auto it = _runs.begin(); it != _runs.end();) {
+    if (frame - it->second.used > maxAge) {
+      it = _runs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
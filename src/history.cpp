@@ -0,0 +1,117 @@
+#include <maolan/ui/history.hpp>
+
+using namespace maolan::ui;
+
+static const std::size_t defaultBudget = 64 << 20;
+
+History *History::history = nullptr;
+
+History::History() : _bytes{0}, _budget{defaultBudget} {}
+
+History *History::get() {
+  if (history) {
+    return history;
+  }
+  history = new History();
+  return history;
+}
+
+std::size_t History::size(const Transaction &transaction) {
+  return sizeof(Transaction) +
+         transaction.edits().capacity() * sizeof(Transaction::Edit);
+}
+
+void History::record(Transaction &&transaction) {
+  if (!_held.empty()) {
+    transaction.restore(_held);
+    _held.clear();
+  }
+  for (const auto &t : _undone) {
+    _bytes -= size(t);
+  }
+  _undone.clear();
+  transaction.shrink();
+  _bytes += size(transaction);
+  _done.push_back(std::move(transaction));
+  trim();
+}
+
+void History::hold(const Transaction &transaction) {
+  for (const auto &edit : transaction.edits()) {
+    if (edit.kind == Transaction::Move) {
+      _held.emplace(edit.clip, std::make_pair(edit.before[0], edit.before[1]));
+    }
+  }
+}
+
+void History::undo() {
+  Transaction::flush();
+  if (_done.empty()) {
+    return;
+  }
+  _done.back().apply(true);
+  _undone.push_back(std::move(_done.back()));
+  _done.pop_back();
+}
+
+void History::redo() {
+  Transaction::flush();
+  if (_undone.empty()) {
+    return;
+  }
+  _undone.back().apply();
+  _done.push_back(std::move(_undone.back()));
+  _undone.pop_back();
+}
+
+void History::forget(const audio::Clip *clip) {
+  _held.erase(const_cast<audio::Clip *>(clip));
+  forget(_done, clip);
+  forget(_undone, clip);
+}
+
+void History::forget(const audio::Track *track) {
+  forget(_done, track);
+  forget(_undone, track);
+}
+
+template <typename K>
+void History::forget(std::deque<Transaction> &transactions, const K *key) {
+  for (auto it = transactions.begin(); it != transactions.end();) {
+    const auto count = it->edits().size();
+    it->forget(key);
+    if (it->edits().size() == count) {
+      ++it;
+      continue;
+    }
+    _bytes -= size(*it);
+    if (it->empty()) {
+      it = transactions.erase(it);
+      continue;
+    }
+    it->shrink();
+    _bytes += size(*it);
+    ++it;
+  }
+}
+
+void History::trim() {
+  while (_bytes > _budget && !_done.empty()) {
+    _bytes -= size(_done.front());
+    _done.pop_front();
+  }
+  while (_bytes > _budget && !_undone.empty()) {
+    _bytes -= size(_undone.front());
+    _undone.pop_front();
+  }
+}
+
+bool History::undoable() const { return !_done.empty(); }
+bool History::redoable() const { return !_undone.empty(); }
+std::size_t History::bytes() const { return _bytes; }
+std::size_t History::budget() const { return _budget; }
+
+void History::budget(const std::size_t &bytes) {
+  _budget = bytes;
+  trim();
+}
@@ -0,0 +1,55 @@
+#include <cmath>
+#include <maolan/config.hpp>
+#include <maolan/ui/lod.hpp>
+#include <maolan/ui/tempomap.hpp>
+
+using namespace maolan::ui;
+
+static const float minSpacing = 25;
+
+std::array<int, 32> LOD::steps;
+float LOD::spt = 0;
+
+LOD::LOD(const float &zoom) {
+  float reference = TempoMap::get()->reference();
+  if (reference <= 0) {
+    reference = Config::tempos[Config::tempoIndex].spt;
+  }
+  if (reference != spt) {
+    build(reference);
+  }
+  float level = std::log2(zoom < 1 ? 1 : zoom);
+  int index = (int)level;
+  if (index >= (int)steps.size() - 1) {
+    index = steps.size() - 2;
+    level = index;
+  }
+  step = steps[index];
+  coarse = steps[index + 1];
+  fade = level - index;
+}
+
+float LOD::alpha(const int &bar) const {
+  if (bar % coarse == 0) {
+    return 1;
+  }
+  return 1 - fade;
+}
+
+void LOD::build(const float &s) {
+  spt = s;
+  int previous = 1;
+  for (std::size_t level = 0; level < steps.size(); ++level) {
+    const float delta = spt / (float)(1u << level);
+    int nth = 1;
+    if (delta <= minSpacing) {
+      for (nth = 4; (delta * nth) < minSpacing; nth += 4)
+        ;
+    }
+    if (nth % previous != 0) {
+      nth = (nth / previous + 1) * previous;
+    }
+    steps[level] = nth;
+    previous = nth;
+  }
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <iterator>
+#include <maolan/ui/markers.hpp>
+
+using namespace maolan::ui;
+
+static const auto earlier = [](const Markers::Marker &a,
+                               const Markers::Marker &b) {
+  return a.start < b.start;
+};
+
+static const auto before = [](const Markers::Marker &m,
+                              const double &position) {
+  return m.start < position;
+};
+
+static const auto after = [](const double &position,
+                             const Markers::Marker &m) {
+  return position < m.start;
+};
+
+Markers *Markers::markers = nullptr;
+
+Markers::Markers() : _version{0} {}
+
+Markers *Markers::get() {
+  if (markers) {
+    return markers;
+  }
+  markers = new Markers();
+  return markers;
+}
+
+void Markers::add(const uint64_t &start, const uint64_t &end,
+                  const std::string &name) {
+  std::vector<Marker> one = {{start, std::max(start, end), name, 0}};
+  add(one);
+}
+
+void Markers::add(std::vector<Marker> &added) {
+  bool points = false;
+  bool ranges = false;
+  for (auto &m : added) {
+    m.end = std::max(m.start, m.end);
+    if (m.end == m.start) {
+      _points.push_back(std::move(m));
+      points = true;
+    } else {
+      _ranges.push_back(std::move(m));
+      ranges = true;
+    }
+  }
+  if (points) {
+    index(_points);
+  }
+  if (ranges) {
+    index(_ranges);
+  }
+  ++_version;
+}
+
+void Markers::index(std::vector<Marker> &list) {
+  std::stable_sort(list.begin(), list.end(), earlier);
+  uint64_t reach = 0;
+  for (auto &m : list) {
+    reach = std::max(reach, m.end);
+    m.reach = reach;
+  }
+}
+
+void Markers::clear() {
+  _points.clear();
+  _ranges.clear();
+  ++_version;
+}
+
+void Markers::visible(const double &from, const double &to,
+                      std::vector<const Marker *> &found) const {
+  auto first = std::lower_bound(_points.begin(), _points.end(), from, before);
+  auto last = std::upper_bound(first, _points.end(), to, after);
+  for (auto it = first; it != last; ++it) {
+    found.push_back(&*it);
+  }
+  last = std::upper_bound(_ranges.begin(), _ranges.end(), to, after);
+  for (auto it = std::make_reverse_iterator(last); it != _ranges.rend();
+       ++it) {
+    if (it->reach < from) {
+      break;
+    }
+    if (it->end >= from) {
+      found.push_back(&*it);
+    }
+  }
+}
+
+bool Markers::next(const double &position, uint64_t &target) const {
+  bool found = false;
+  for (const auto *list : {&_points, &_ranges}) {
+    auto it = std::upper_bound(list->begin(), list->end(), position, after);
+    if (it != list->end() && (!found || it->start < target)) {
+      target = it->start;
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool Markers::previous(const double &position, uint64_t &target) const {
+  bool found = false;
+  for (const auto *list : {&_points, &_ranges}) {
+    auto it = std::lower_bound(list->begin(), list->end(), position, before);
+    if (it != list->begin() && (!found || (it - 1)->start > target)) {
+      target = (it - 1)->start;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void Markers::positions(std::vector<uint64_t> &out) const {
+  out.clear();
+  for (const auto &m : _points) {
+    out.push_back(m.start);
+  }
+  for (const auto &m : _ranges) {
+    out.push_back(m.start);
+    out.push_back(m.end);
+  }
+}
+
+std::size_t Markers::size() const { return _points.size() + _ranges.size(); }
+
+uint64_t Markers::version() const { return _version; }
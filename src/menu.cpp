@@ -1,10 +1,96 @@
+#include <algorithm>
 #include <imgui.h>
+#include <maolan/io.hpp>
 #include <maolan/ui/app.hpp>
+#include <maolan/ui/history.hpp>
+#include <maolan/ui/markers.hpp>
 #include <maolan/ui/menu.hpp>
+#include <maolan/ui/ripple.hpp>
+#include <maolan/ui/selection.hpp>
+#include <maolan/ui/snap.hpp>
+#include <maolan/ui/state.hpp>
+#include <maolan/ui/stats.hpp>
+#include <maolan/ui/tempomap.hpp>
+#include <maolan/ui/widgets/timetrack.hpp>
+#include <string>
 
 using namespace maolan::ui;
 
+static auto state = State::get();
+
+uint64_t Menu::beat() {
+  auto map = TempoMap::get();
+  const double position = IO::playHead();
+  const double beat = map->beat(position);
+  return map->sample(beat + 1) - position;
+}
+
+void Menu::region() {
+  uint64_t start = UINT64_MAX;
+  uint64_t end = 0;
+  for (auto clip : Selection::get()->clips()) {
+    start = std::min<uint64_t>(start, clip->start());
+    end = std::max<uint64_t>(end, clip->end());
+  }
+  auto markers = Markers::get();
+  markers->add(start, end, "Region " + std::to_string(markers->size() + 1));
+}
+
+void Menu::tempo() {
+  auto map = TempoMap::get();
+  if (map->segments().empty()) {
+    return;
+  }
+  const double beat = map->beat(IO::playHead());
+  std::size_t index = map->find(beat);
+  if (ImGui::MenuItem("Split at playhead")) {
+    index = map->add(beat);
+  }
+  auto segment = map->segments()[index];
+  bool changed = ImGui::DragFloat("samples per beat", &segment.spt, 10, 1,
+                                  1 << 24, "%.0f");
+  changed |= ImGui::Checkbox("ramp to next", &segment.ramp);
+  changed |= ImGui::InputInt("beats per bar", &segment.numerator);
+  if (changed) {
+    map->set(index, segment.spt, segment.ramp, segment.numerator,
+             segment.denominator);
+  }
+  if (ImGui::MenuItem("Remove", nullptr, false, index > 0)) {
+    map->remove(index);
+  }
+}
+
+void Menu::ruler() {
+  static const char *formats[] = {"Bars/beats", "Timecode", "Min:sec",
+                                  "Samples"};
+  for (int i = 0; i < 4; ++i) {
+    if (ImGui::MenuItem(formats[i], nullptr, state->ruler == i)) {
+      state->ruler = i;
+    }
+  }
+  ImGui::Separator();
+  if (ImGui::BeginMenu("Frame rate")) {
+    for (int i = 0; i < TimeTrack::rateCount; ++i) {
+      if (ImGui::MenuItem(TimeTrack::rates[i].name, nullptr,
+                          state->fps == i)) {
+        state->fps = i;
+      }
+    }
+    ImGui::EndMenu();
+  }
+  ImGui::DragFloat("sample rate", &state->rate, 100, 8000, 384000, "%.0f");
+}
+
 void Menu::draw(App *app) {
+  auto history = History::get();
+  const auto &io = ImGui::GetIO();
+  if (io.KeyCtrl && !ImGui::IsAnyItemActive()) {
+    if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Z))) {
+      io.KeyShift ? history->redo() : history->undo();
+    } else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Y))) {
+      history->redo();
+    }
+  }
   if (ImGui::BeginMainMenuBar()) {
     if (ImGui::BeginMenu("File")) {
       if (ImGui::MenuItem("New")) {
@@ -16,6 +102,51 @@ void Menu::draw(App *app) {
       ImGui::EndMenu();
     }
     if (ImGui::BeginMenu("Edit")) {
+      if (ImGui::MenuItem("Undo", "Ctrl+Z", false, history->undoable())) {
+        history->undo();
+      }
+      if (ImGui::MenuItem("Redo", "Ctrl+Y", false, history->redoable())) {
+        history->redo();
+      }
+      ImGui::Separator();
+      if (ImGui::MenuItem("Ripple insert beat")) {
+        Ripple ripple;
+        ripple.insert(IO::playHead(), beat());
+        ripple.commit();
+      }
+      if (ImGui::MenuItem("Ripple delete beat")) {
+        Ripple ripple;
+        ripple.remove(IO::playHead(), beat());
+        ripple.commit();
+      }
+      if (ImGui::MenuItem("Add marker at playhead")) {
+        auto markers = Markers::get();
+        markers->add(IO::playHead(), IO::playHead(),
+                     "Marker " + std::to_string(markers->size() + 1));
+      }
+      if (ImGui::MenuItem("Add region from selection", nullptr, false,
+                          !Selection::get()->empty())) {
+        region();
+      }
+      if (ImGui::BeginMenu("Tempo")) {
+        tempo();
+        ImGui::EndMenu();
+      }
+      ImGui::Separator();
+      if (ImGui::BeginMenu("Snap")) {
+        auto snap = Snap::get();
+        ImGui::MenuItem("Enabled", nullptr, &state->snap);
+        ImGui::MenuItem("Grid", nullptr, &snap->sources[Snap::Grid]);
+        ImGui::MenuItem("Clip edges", nullptr, &snap->sources[Snap::Edges]);
+        ImGui::MenuItem("Markers", nullptr, &snap->sources[Snap::Markers]);
+        if (ImGui::MenuItem("Transients", nullptr,
+                            &snap->sources[Snap::Transients])) {
+          snap->invalidate();
+        }
+        ImGui::MenuItem("All tracks", nullptr, &snap->all);
+        ImGui::EndMenu();
+      }
+      ImGui::MenuItem("Live audition", nullptr, &state->audition);
       if (ImGui::MenuItem("Preferences")) {
       }
       ImGui::EndMenu();
@@ -24,6 +155,16 @@ void Menu::draw(App *app) {
       if (ImGui::MenuItem("Tracks")) {
         app->tracks().toggle();
       }
+      ImGui::MenuItem("Instanced timeline", nullptr, &state->instanced);
+      ImGui::MenuItem("Split channels", nullptr, &state->split);
+      ImGui::MenuItem("Low-latency input", nullptr, &state->latency);
+      ImGui::MenuItem("Pipelined rendering", nullptr, &state->pipelined);
+      ImGui::MenuItem("Parallel lanes", nullptr, &state->parallel);
+      if (ImGui::BeginMenu("Ruler")) {
+        ruler();
+        ImGui::EndMenu();
+      }
+      ImGui::MenuItem("Statistics", nullptr, &Stats::get()->shown);
       ImGui::EndMenu();
     }
     ImGui::EndMainMenuBar();
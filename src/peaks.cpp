@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+#include <maolan/ui/peaks.hpp>
+#include <maolan/ui/scheduler.hpp>
+#include <maolan/ui/workers.hpp>
+
+using namespace maolan::ui;
+
+static const float onsetFloor = 0.05;
+static const float onsetRatio = 2;
+static const float onsetDecay = 0.9;
+static const std::size_t onsetGap = 16;
+
+Peaks::Source Peaks::source;
+std::map<maolan::audio::Clip *, std::shared_ptr<Peaks>> Peaks::peaks;
+std::mutex Peaks::mutex;
+uint64_t Peaks::published = 0;
+
+Peaks::Peaks() : channels{0}, frames{0}, stride{0}, ready{false} {}
+
+std::shared_ptr<Peaks> Peaks::get(maolan::audio::Clip *clip,
+                                  const Scheduler::Priority &priority) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = peaks.find(clip);
+  if (it != peaks.end()) {
+    return it->second->ready ? it->second : nullptr;
+  }
+  if (!source) {
+    return nullptr;
+  }
+  auto p = std::make_shared<Peaks>();
+  peaks[clip] = p;
+  Workers::get()->post([clip, p, priority] {
+    std::vector<float> samples;
+    std::size_t channels = 0;
+    if (source(clip, samples, channels) && channels > 0) {
+      p->build(samples, channels);
+      Scheduler::get()->post(
+          [p] {
+            p->ready = true;
+            ++published;
+            return true;
+          },
+          priority);
+    }
+  });
+  return nullptr;
+}
+
+std::shared_ptr<Peaks> Peaks::find(maolan::audio::Clip *clip) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = peaks.find(clip);
+  if (it == peaks.end() || !it->second->ready) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+uint64_t Peaks::version() { return published; }
+
+void Peaks::forget(maolan::audio::Clip *clip) {
+  std::lock_guard<std::mutex> lock(mutex);
+  peaks.erase(clip);
+}
+
+void Peaks::build(const std::vector<float> &samples,
+                  const std::size_t &count) {
+  channels = count;
+  frames = samples.size() / channels;
+  offsets.clear();
+  sizes.clear();
+  stride = 0;
+  for (std::size_t blocks = (frames + base - 1) / base; blocks > 0;
+       blocks = blocks == 1 ? 0 : (blocks + 1) / 2) {
+    offsets.push_back(stride);
+    sizes.push_back(blocks);
+    stride += blocks;
+  }
+  data.assign(channels * stride, {0, 0});
+  for (std::size_t channel = 0; channel < channels; ++channel) {
+    for (std::size_t block = 0; block < sizes[0]; ++block) {
+      ImVec2 p = {INFINITY, -INFINITY};
+      const std::size_t end = std::min(frames, (block + 1) * base);
+      for (std::size_t frame = block * base; frame < end; ++frame) {
+        const float sample = samples[frame * channels + channel];
+        p.x = std::min(p.x, sample);
+        p.y = std::max(p.y, sample);
+      }
+      data[index(channel, 0, block)] = p;
+    }
+    for (std::size_t level = 1; level < sizes.size(); ++level) {
+      for (std::size_t block = 0; block < sizes[level]; ++block) {
+        const auto &a = data[index(channel, level - 1, block * 2)];
+        const std::size_t next = std::min(block * 2 + 1, sizes[level - 1] - 1);
+        const auto &b = data[index(channel, level - 1, next)];
+        data[index(channel, level, block)] = {std::min(a.x, b.x),
+                                              std::max(a.y, b.y)};
+      }
+    }
+  }
+  detect();
+}
+
+void Peaks::detect() {
+  transients.clear();
+  if (sizes.empty()) {
+    return;
+  }
+  float envelope = 0;
+  std::size_t last = 0;
+  for (std::size_t block = 0; block < sizes[0]; ++block) {
+    float level = 0;
+    for (std::size_t channel = 0; channel < channels; ++channel) {
+      const auto &p = data[index(channel, 0, block)];
+      level = std::max(level, std::max(-p.x, p.y));
+    }
+    if (level > onsetFloor && level > envelope * onsetRatio &&
+        (transients.empty() || block - last >= onsetGap)) {
+      transients.push_back(block * base);
+      last = block;
+    }
+    envelope = std::max(level, envelope * onsetDecay);
+  }
+}
+
+std::size_t Peaks::index(const std::size_t &channel, const std::size_t &level,
+                         const std::size_t &block) const {
+  return channel * stride + offsets[level] + block;
+}
+
+std::size_t Peaks::level(const float &zoom) const {
+  if (zoom <= base) {
+    return 0;
+  }
+  const std::size_t l = std::log2(zoom / base);
+  return std::min(l, sizes.size() - 1);
+}
+
+ImVec2 Peaks::peak(const std::size_t &channel, const std::size_t &l,
+                   const std::size_t &from, const std::size_t &to) const {
+  ImVec2 p = {INFINITY, -INFINITY};
+  const std::size_t last = std::min(to, sizes[l]);
+  for (std::size_t block = from; block < last; ++block) {
+    const auto &v = data[index(channel, l, block)];
+    p.x = std::min(p.x, v.x);
+    p.y = std::max(p.y, v.y);
+  }
+  return p;
+}
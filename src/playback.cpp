@@ -1,6 +1,8 @@
 #include <imgui.h>
 #include <maolan/engine.hpp>
 #include <maolan/ui/playback.hpp>
+#include <maolan/ui/stats.hpp>
+#include <maolan/ui/transport.hpp>
 
 using namespace maolan::ui;
 
@@ -9,10 +11,14 @@ void Playback::draw() {
   {
     if (_playButton.draw()) {
       Engine::play();
+      Stats::get()->engine();
+      Transport::get()->reset();
     }
     ImGui::SameLine();
     if (_stopButton.draw()) {
       Engine::stop();
+      Stats::get()->engine();
+      Transport::get()->reset();
     }
   }
   ImGui::End();
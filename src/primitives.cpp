@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <maolan/ui/damage.hpp>
+#include <maolan/ui/primitives.hpp>
+#include <maolan/ui/state.hpp>
+
+using namespace maolan::ui;
+
+static auto state = State::get();
+
+std::vector<Primitives::Batch *> Primitives::batches[2];
+std::size_t Primitives::used[2] = {0, 0};
+int Primitives::current = 0;
+Primitives *Primitives::primitives = nullptr;
+
+void Primitives::Batch::clip(const ImVec2 &minimum, const ImVec2 &maximum) {
+  clipRect = {minimum.x, minimum.y, maximum.x, maximum.y};
+}
+
+void Primitives::Batch::rect(const ImVec2 &minimum, const ImVec2 &maximum,
+                             const ImU32 &color, const float &rounding) {
+  if (!instanced) {
+    drawList->AddRectFilled(minimum, maximum, color, rounding);
+    return;
+  }
+  const Rect r = {{std::max(minimum.x, clipRect.x),
+                   std::max(minimum.y, clipRect.y)},
+                  {std::min(maximum.x, clipRect.z),
+                   std::min(maximum.y, clipRect.w)},
+                  color};
+  if (r.min.x < r.max.x && r.min.y < r.max.y) {
+    rects.push_back(r);
+  }
+}
+
+void Primitives::Batch::outline(const ImVec2 &minimum, const ImVec2 &maximum,
+                                const ImU32 &color, const float &rounding) {
+  if (!instanced) {
+    drawList->AddRect(minimum, maximum, color, rounding);
+    return;
+  }
+  rect(minimum, {maximum.x, minimum.y + 1}, color);
+  rect({minimum.x, maximum.y - 1}, maximum, color);
+  rect({minimum.x, minimum.y + 1}, {minimum.x + 1, maximum.y - 1}, color);
+  rect({maximum.x - 1, minimum.y + 1}, {maximum.x, maximum.y - 1}, color);
+}
+
+void Primitives::Batch::line(const float &x, const float &top,
+                             const float &bottom, const ImU32 &color) {
+  if (!instanced) {
+    drawList->AddLine({x, top}, {x, bottom}, color, 1);
+    return;
+  }
+  rect({x - 0.5f, top}, {x + 0.5f, bottom}, color);
+}
+
+void Primitives::Batch::span(const float &x, const float &top,
+                             const float &bottom, const ImU32 &color) {
+  if (!instanced) {
+    drawList->AddRectFilled({x, top}, {x + 1, bottom}, color);
+    return;
+  }
+  rect({x, top}, {x + 1, bottom}, color);
+}
+
+Primitives::Primitives() : _target{nullptr} {
+  primitives = this;
+  Damage::get()->reported(callback);
+  Damage::get()->reported(ImDrawCallback_ResetRenderState);
+}
+
+Primitives::~Primitives() {
+  if (primitives == this) {
+    primitives = nullptr;
+  }
+}
+
+Primitives *Primitives::get() { return primitives; }
+
+Primitives::Batch *Primitives::batch(ImDrawList *drawList,
+                                     const bool &screen) {
+  auto &pool = batches[current];
+  if (used[current] == pool.size()) {
+    pool.push_back(new Batch());
+  }
+  auto b = pool[used[current]++];
+  b->rects.clear();
+  b->drawList = drawList;
+  const auto minimum = drawList->GetClipRectMin();
+  const auto maximum = drawList->GetClipRectMax();
+  b->clip(minimum, maximum);
+  b->instanced = primitives != nullptr && state->instanced;
+  b->screen = screen;
+  if (b->instanced) {
+    drawList->AddCallback(callback, b);
+    drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+  }
+  return b;
+}
+
+void Primitives::finish() {
+  static const std::vector<Rect> none;
+  auto damage = Damage::get();
+  const int last = 1 - current;
+  const std::size_t count = std::max(used[current], used[last]);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto a = i < used[current] ? batches[current][i] : nullptr;
+    const auto p = i < used[last] ? batches[last][i] : nullptr;
+    const auto &now = a && a->screen ? a->rects : none;
+    const auto &before = p && p->screen ? p->rects : none;
+    const std::size_t common = std::min(now.size(), before.size());
+    for (std::size_t r = 0; r < common; ++r) {
+      const auto &n = now[r];
+      const auto &b = before[r];
+      if (n.min.x != b.min.x || n.min.y != b.min.y || n.max.x != b.max.x ||
+          n.max.y != b.max.y || n.color != b.color) {
+        damage->add(n.min, n.max);
+        damage->add(b.min, b.max);
+      }
+    }
+    for (std::size_t r = common; r < now.size(); ++r) {
+      damage->add(now[r].min, now[r].max);
+    }
+    for (std::size_t r = common; r < before.size(); ++r) {
+      damage->add(before[r].min, before[r].max);
+    }
+  }
+  current = last;
+  used[current] = 0;
+}
+
+void Primitives::target(const ImDrawData *data) { _target = data; }
+
+void Primitives::callback(const ImDrawList *drawList, const ImDrawCmd *cmd) {
+  if (primitives) {
+    primitives->draw(*(const Batch *)cmd->UserCallbackData, *cmd);
+  }
+}
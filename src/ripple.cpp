@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <maolan/ui/ripple.hpp>
+#include <maolan/ui/transaction.hpp>
+#include <utility>
+
+using namespace maolan::ui;
+
+Ripple::Lane &Ripple::lane(Track &track) {
+  auto result = _lanes.emplace(track.audio(), Lane{});
+  auto &l = result.first->second;
+  if (result.second) {
+    l.clips = track.clips();
+    l.deltas.assign(l.clips ? l.clips->size() : 0, 0);
+    l.first = l.clips ? l.clips->size() : 0;
+  }
+  return l;
+}
+
+void Ripple::shift(const uint64_t &at, const int64_t &amount) {
+  if (amount == 0) {
+    return;
+  }
+  for (auto &track : Track::registry) {
+    auto &l = lane(track);
+    if (!l.clips) {
+      continue;
+    }
+    const auto it = std::lower_bound(
+        l.clips->begin(), l.clips->end(), at,
+        [](const Track::Span &span, const uint64_t &position) {
+          return span.start < position;
+        });
+    const std::size_t index = it - l.clips->begin();
+    if (index < l.clips->size()) {
+      l.deltas[index] += amount;
+      l.first = std::min(l.first, index);
+    }
+  }
+}
+
+void Ripple::insert(const uint64_t &at, const uint64_t &length) {
+  shift(at, length);
+}
+
+void Ripple::remove(const uint64_t &at, const uint64_t &length) {
+  shift(at + length, -(int64_t)length);
+}
+
+void Ripple::commit() {
+  Transaction transaction;
+  for (auto &entry : _lanes) {
+    auto &l = entry.second;
+    if (!l.clips) {
+      continue;
+    }
+    auto track = const_cast<audio::Track *>(entry.first);
+    int64_t offset = 0;
+    for (std::size_t i = l.first; i < l.clips->size(); ++i) {
+      offset += l.deltas[i];
+      if (offset == 0) {
+        continue;
+      }
+      const auto &span = (*l.clips)[i];
+      const int64_t floor = -(int64_t)span.start;
+      const int64_t delta = std::max(offset, floor);
+      transaction.move(track, span.clip, span.start + delta,
+                       span.end + delta);
+    }
+  }
+  _lanes.clear();
+  Transaction::commit(std::move(transaction));
+}
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <maolan/ui/scheduler.hpp>
+
+using namespace maolan::ui;
+
+Scheduler *Scheduler::scheduler = nullptr;
+
+bool Scheduler::Entry::operator<(const Entry &other) const {
+  if (priority != other.priority) {
+    return priority > other.priority;
+  }
+  return order > other.order;
+}
+
+Scheduler::Scheduler() : _order{0} {}
+
+Scheduler *Scheduler::get() {
+  if (scheduler) {
+    return scheduler;
+  }
+  scheduler = new Scheduler();
+  return scheduler;
+}
+
+void Scheduler::post(const Task &task, const Priority &priority) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tasks.push({task, priority, _order++});
+}
+
+std::size_t Scheduler::pending() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _tasks.size();
+}
+
+void Scheduler::run(const double &budget) {
+  using clock = std::chrono::steady_clock;
+  const auto deadline =
+      clock::now() + std::chrono::duration<double>(budget);
+  do {
+    Entry entry;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_tasks.empty()) {
+        return;
+      }
+      entry = _tasks.top();
+      _tasks.pop();
+    }
+    if (!entry.task()) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _tasks.push({entry.task, entry.priority, _order++});
+    }
+  } while (clock::now() < deadline);
+}
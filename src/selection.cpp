@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <imgui.h>
+#include <iterator>
+#include <maolan/ui/selection.hpp>
+
+using namespace maolan::ui;
+
+Selection *Selection::selection = nullptr;
+
+Selection::Selection() {}
+
+Selection *Selection::get() {
+  if (selection) {
+    return selection;
+  }
+  selection = new Selection();
+  return selection;
+}
+
+Selection::Mode Selection::mode() {
+  const auto &io = ImGui::GetIO();
+  if (io.KeyCtrl) {
+    return Toggle;
+  }
+  if (io.KeyShift) {
+    return Add;
+  }
+  return Replace;
+}
+
+void Selection::apply(std::vector<audio::Clip *> &clips, const Mode &mode) {
+  std::sort(clips.begin(), clips.end());
+  clips.erase(std::unique(clips.begin(), clips.end()), clips.end());
+  _scratch.clear();
+  switch (mode) {
+  case Replace:
+    _scratch = clips;
+    break;
+  case Add:
+    std::set_union(_clips.begin(), _clips.end(), clips.begin(), clips.end(),
+                   std::back_inserter(_scratch));
+    break;
+  case Toggle:
+    std::set_symmetric_difference(_clips.begin(), _clips.end(), clips.begin(),
+                                  clips.end(), std::back_inserter(_scratch));
+    break;
+  }
+  _clips.swap(_scratch);
+}
+
+void Selection::clear() { _clips.clear(); }
+
+void Selection::forget(const audio::Clip *clip) {
+  auto it = std::lower_bound(_clips.begin(), _clips.end(), clip);
+  if (it != _clips.end() && *it == clip) {
+    _clips.erase(it);
+  }
+}
+
+bool Selection::contains(const audio::Clip *clip) const {
+  return std::binary_search(_clips.begin(), _clips.end(), clip);
+}
+
+bool Selection::empty() const { return _clips.empty(); }
+
+const std::vector<maolan::audio::Clip *> &Selection::clips() const {
+  return _clips;
+}
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cmath>
+#include <imgui.h>
+#include <maolan/ui/lod.hpp>
+#include <maolan/ui/markers.hpp>
+#include <maolan/ui/peaks.hpp>
+#include <maolan/ui/snap.hpp>
+#include <maolan/ui/state.hpp>
+#include <maolan/ui/tempomap.hpp>
+#include <maolan/ui/track.hpp>
+
+using namespace maolan::ui;
+
+static auto state = State::get();
+static const float tolerance = 8;
+
+Snap *Snap::snap = nullptr;
+
+Snap::Snap()
+    : sources{true, true, true, true}, all{false}, _marked{0}, _peaks{0},
+      _dirty{true} {}
+
+Snap *Snap::get() {
+  if (snap) {
+    return snap;
+  }
+  snap = new Snap();
+  return snap;
+}
+
+void Snap::invalidate() { _dirty = true; }
+
+void Snap::invalidate(const audio::Track *track) { _stale.insert(track); }
+
+void Snap::refresh() {
+  if (Peaks::version() != _peaks) {
+    _peaks = Peaks::version();
+    _stale.insert(_waiting.begin(), _waiting.end());
+  }
+  if (_edges.size() != Track::registry.size()) {
+    _dirty = true;
+  }
+  if (!_dirty && _stale.empty()) {
+    return;
+  }
+  if (_dirty) {
+    _edges.clear();
+    _transients.clear();
+    _waiting.clear();
+  }
+  for (auto &t : Track::registry) {
+    if (_dirty || _stale.count(t.audio())) {
+      collect(t);
+    }
+  }
+  _stale.clear();
+  _dirty = false;
+}
+
+void Snap::collect(Track &track) {
+  auto &edges = _edges[track.audio()];
+  auto &transients = _transients[track.audio()];
+  edges.clear();
+  transients.clear();
+  _waiting.erase(track.audio());
+  const auto clips = track.clips();
+  for (const auto &span : *clips) {
+    edges.push_back({span.start, span.clip});
+    edges.push_back({span.end, span.clip});
+    if (!sources[Transients]) {
+      continue;
+    }
+    // only pyramids someone else asked for, snapping never starts a build
+    auto peaks = Peaks::find(span.clip);
+    if (!peaks) {
+      if (Peaks::source) {
+        _waiting.insert(track.audio());
+      }
+      continue;
+    }
+    for (const auto &offset : peaks->transients) {
+      if (span.start + offset >= span.end) {
+        break;
+      }
+      transients.push_back({span.start + offset, span.clip});
+    }
+  }
+  const auto before = [](const Point &a, const Point &b) {
+    return a.position < b.position;
+  };
+  std::sort(edges.begin(), edges.end(), before);
+  std::sort(transients.begin(), transients.end(), before);
+}
+
+void Snap::nearest(const Lanes &lanes, const audio::Track *track,
+                   const bool &all, const double &position,
+                   const audio::Clip *const *ignore, const std::size_t &ignored,
+                   double &best, double &distance) {
+  // every lane is sorted on its own, so searching them one by one keeps an
+  // edit to one track from touching the others
+  if (all) {
+    for (const auto &lane : lanes) {
+      nearest(lane.second, position, ignore, ignored, best, distance);
+    }
+    return;
+  }
+  const auto it = lanes.find(track);
+  if (it != lanes.end()) {
+    nearest(it->second, position, ignore, ignored, best, distance);
+  }
+}
+
+void Snap::nearest(const Points &targets, const double &position,
+                   const audio::Clip *const *ignore, const std::size_t &ignored,
+                   double &best, double &distance) {
+  const auto skip = [ignore, ignored](const Point &point) {
+    return std::find(ignore, ignore + ignored, point.clip) != ignore + ignored;
+  };
+  auto right = std::lower_bound(
+      targets.begin(), targets.end(), position,
+      [](const Point &point, const double &p) { return point.position < p; });
+  for (auto it = right; it != targets.end(); ++it) {
+    if (it->position - position >= distance) {
+      break;
+    }
+    if (!skip(*it)) {
+      distance = it->position - position;
+      best = it->position;
+      break;
+    }
+  }
+  for (auto it = std::make_reverse_iterator(right); it != targets.rend();
+       ++it) {
+    if (position - it->position >= distance) {
+      break;
+    }
+    if (!skip(*it)) {
+      distance = position - it->position;
+      best = it->position;
+      break;
+    }
+  }
+}
+
+bool Snap::find(const double &position, const audio::Track *track,
+                const audio::Clip *const *ignore, const std::size_t &ignored,
+                double &target) {
+  if (!state->snap || ImGui::GetIO().KeyAlt) {
+    return false;
+  }
+  refresh();
+  double distance = tolerance * state->zoom;
+  double best = position;
+  if (sources[Grid]) {
+    const LOD lod(state->zoom);
+    const auto map = TempoMap::get();
+    const double beat = map->beat(position);
+    const double below = map->sample(std::floor(beat / lod.step) * lod.step);
+    const double above = map->sample(std::ceil(beat / lod.step) * lod.step);
+    for (const double line : {below, above}) {
+      if (std::fabs(line - position) < distance) {
+        distance = std::fabs(line - position);
+        best = line;
+      }
+    }
+  }
+  if (sources[Edges]) {
+    nearest(_edges, track, all, position, ignore, ignored, best, distance);
+  }
+  if (sources[Markers]) {
+    const auto markers = maolan::ui::Markers::get();
+    if (markers->version() != _marked) {
+      _marked = markers->version();
+      markers->positions(_marks);
+      std::sort(_marks.begin(), _marks.end());
+      _markers.clear();
+      for (const auto &mark : _marks) {
+        _markers.push_back({mark, nullptr});
+      }
+    }
+    nearest(_markers, position, nullptr, 0, best, distance);
+  }
+  if (sources[Transients]) {
+    nearest(_transients, track, all, position, ignore, ignored, best,
+            distance);
+  }
+  if (distance >= tolerance * state->zoom) {
+    return false;
+  }
+  target = best;
+  return true;
+}
@@ -4,7 +4,10 @@ using namespace maolan::ui;
 
 State *State::state = nullptr;
 
-State::State() : zoom{1 << 10} {}
+State::State()
+    : zoom{1 << 10}, zoomTarget{1 << 10}, origin{0}, instanced{true},
+      split{false}, latency{false}, pipelined{false}, parallel{false},
+      snap{true}, audition{false}, ruler{0}, fps{1}, rate{48000}, present{0} {}
 
 State::~State() {}
 
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <imgui.h>
+#include <maolan/ui/stats.hpp>
+
+using namespace maolan::ui;
+
+Stats *Stats::stats = nullptr;
+
+Stats::Stats()
+    : shown{false}, frameTime{0}, stallTime{0}, uploaded{0},
+      engineLatency{0}, photonLatency{0}, _stall{0}, _uploaded{0},
+      _pending{0}, _latched{0} {}
+
+Stats *Stats::get() {
+  if (stats) {
+    return stats;
+  }
+  stats = new Stats();
+  return stats;
+}
+
+void Stats::draw() {
+  if (!shown) {
+    return;
+  }
+  ImGui::Begin("Statistics", &shown);
+  {
+    ImGui::Text("Frame: %.2f ms", frameTime * 1000);
+    ImGui::Text("Upload: %.1f KiB", uploaded / 1024.0);
+    ImGui::Text("Stall: %.3f ms", stallTime * 1000);
+    ImGui::Text("Input to engine: %.2f ms", engineLatency * 1000);
+    ImGui::Text("Input to photon: %.2f ms", photonLatency * 1000);
+  }
+  ImGui::End();
+}
+
+void Stats::frame(const double &seconds) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  frameTime = seconds;
+  stallTime = _stall;
+  uploaded = _uploaded;
+  _stall = 0;
+  _uploaded = 0;
+}
+
+void Stats::upload(const std::size_t &bytes) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _uploaded += bytes;
+}
+
+void Stats::stall(const double &seconds) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _stall += seconds;
+}
+
+double Stats::now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Stats::input() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_pending == 0) {
+    _pending = now();
+  }
+}
+
+void Stats::latch() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_pending != 0 && _latched == 0) {
+    _latched = _pending;
+  }
+  _pending = 0;
+}
+
+void Stats::engine() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_latched != 0) {
+    engineLatency = now() - _latched;
+  }
+}
+
+void Stats::photon() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_latched != 0) {
+    photonLatency = now() - _latched;
+    _latched = 0;
+  }
+}
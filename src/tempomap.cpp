@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <maolan/config.hpp>
+#include <maolan/ui/tempomap.hpp>
+
+using namespace maolan::ui;
+
+TempoMap *TempoMap::map = nullptr;
+
+TempoMap::TempoMap() : _config{0}, _reference{0}, _version{0}, _edited{false} {}
+
+TempoMap *TempoMap::get() {
+  if (map) {
+    return map;
+  }
+  map = new TempoMap();
+  return map;
+}
+
+bool TempoMap::sync(const double &origin) {
+  const auto spt = Config::tempos[Config::tempoIndex].spt;
+  bool changed = false;
+  if (!_edited && spt != _config) {
+    _config = spt;
+    _segments.assign(1, {0, 0, 0, spt, spt, 4, 4, false});
+    rebuild();
+    changed = true;
+  }
+  _reference = this->spt(beat(origin));
+  return changed;
+}
+
+std::size_t TempoMap::add(const double &beat) {
+  const std::size_t index = find(beat);
+  auto segment = _segments[index];
+  if (segment.beat == beat) {
+    return index;
+  }
+  segment.beat = beat;
+  segment.spt = spt(beat);
+  _segments.insert(_segments.begin() + index + 1, segment);
+  _edited = true;
+  rebuild();
+  return index + 1;
+}
+
+void TempoMap::remove(const std::size_t &index) {
+  if (index == 0 || index >= _segments.size()) {
+    return;
+  }
+  _segments.erase(_segments.begin() + index);
+  _edited = true;
+  rebuild();
+}
+
+void TempoMap::set(const std::size_t &index, const float &spt,
+                   const bool &ramp, const int &numerator,
+                   const int &denominator) {
+  auto &segment = _segments[index];
+  segment.spt = std::max(1.0f, spt);
+  segment.ramp = ramp;
+  segment.numerator = std::max(1, numerator);
+  segment.denominator = std::max(1, denominator);
+  _edited = true;
+  rebuild();
+}
+
+double TempoMap::length(const std::size_t &index) const {
+  if (index + 1 >= _segments.size()) {
+    return INFINITY;
+  }
+  return _segments[index + 1].beat - _segments[index].beat;
+}
+
+void TempoMap::rebuild() {
+  for (std::size_t i = 0; i < _segments.size(); ++i) {
+    auto &s = _segments[i];
+    const bool last = i + 1 == _segments.size();
+    s.end = s.ramp && !last ? _segments[i + 1].spt : s.spt;
+    if (i == 0) {
+      s.sample = 0;
+      s.bar = 0;
+      continue;
+    }
+    const auto &p = _segments[i - 1];
+    const double beats = s.beat - p.beat;
+    s.sample = p.sample + beats * (p.spt + p.end) / 2;
+    s.bar = p.bar + beats / p.numerator;
+  }
+  ++_version;
+}
+
+std::size_t TempoMap::find(const double &beat) const {
+  const auto it = std::upper_bound(
+      _segments.begin(), _segments.end(), beat,
+      [](const double &b, const Segment &s) { return b < s.beat; });
+  return it == _segments.begin() ? 0 : it - _segments.begin() - 1;
+}
+
+double TempoMap::beat(const double &sample) const {
+  if (_segments.empty()) {
+    return 0;
+  }
+  const auto it = std::upper_bound(
+      _segments.begin(), _segments.end(), sample,
+      [](const double &t, const Segment &s) { return t < s.sample; });
+  const auto &s = it == _segments.begin() ? *it : *(it - 1);
+  const double t = sample - s.sample;
+  const double slope = (s.end - s.spt) / (2 * length(&s - _segments.data()));
+  if (s.end == s.spt || std::fabs(slope) < 1e-12) {
+    return s.beat + t / s.spt;
+  }
+  return s.beat +
+         (-s.spt + std::sqrt(s.spt * s.spt + 4 * slope * t)) / (2 * slope);
+}
+
+double TempoMap::sample(const double &beat) const {
+  if (_segments.empty()) {
+    return 0;
+  }
+  const auto &s = _segments[find(beat)];
+  const double b = beat - s.beat;
+  if (s.end == s.spt) {
+    return s.sample + b * s.spt;
+  }
+  const double slope = (s.end - s.spt) / (2 * length(&s - _segments.data()));
+  return s.sample + s.spt * b + slope * b * b;
+}
+
+double TempoMap::bar(const double &beat) const {
+  if (_segments.empty()) {
+    return 0;
+  }
+  const auto &s = _segments[find(beat)];
+  return s.bar + (beat - s.beat) / s.numerator;
+}
+
+float TempoMap::spt(const double &beat) const {
+  if (_segments.empty()) {
+    return 0;
+  }
+  const std::size_t index = find(beat);
+  const auto &s = _segments[index];
+  if (s.end == s.spt) {
+    return s.spt;
+  }
+  return s.spt + (s.end - s.spt) * (beat - s.beat) / length(index);
+}
+
+float TempoMap::reference() const { return _reference; }
+uint64_t TempoMap::version() const { return _version; }
+
+const std::vector<TempoMap::Segment> &TempoMap::segments() const {
+  return _segments;
+}
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <maolan/ui/tiles.hpp>
+
+using namespace maolan::ui;
+
+static const int maxPending = 16;
+static const int maxAge = 120;
+
+const float Tiles::width = 256;
+Tiles *Tiles::tiles = nullptr;
+
+Tiles::Tile::Tile()
+    : texture{nullptr}, list{nullptr}, size{0, 0}, from{0}, to{0}, used{0},
+      valid{false}, pending{false} {}
+
+Tiles::Tile::~Tile() {
+  if (list) {
+    IM_DELETE(list);
+  }
+}
+
+Tiles::Tiles() : _budget{maxPending} { tiles = this; }
+
+Tiles::~Tiles() {
+  if (tiles == this) {
+    tiles = nullptr;
+  }
+}
+
+Tiles *Tiles::get() { return tiles; }
+
+int Tiles::level(const float &zoom) { return std::lround(std::log2(zoom) * 4); }
+
+float Tiles::zoom(const int &level) { return std::exp2(level / 4.0f); }
+
+Tiles::Tile *Tiles::find(const void *owner, const int &level,
+                         const long &index, const ImVec2 &size) {
+  auto &tile = _tiles[owner][{level, index}];
+  tile.used = ImGui::GetFrameCount();
+  if (tile.valid) {
+    if (tile.size.x == size.x && tile.size.y == size.y) {
+      return &tile;
+    }
+    tile.valid = false;
+  }
+  if (_budget <= 0) {
+    return nullptr;
+  }
+  --_budget;
+  if (tile.texture && (tile.size.x != size.x || tile.size.y != size.y)) {
+    // the previous frame may still be sampling it on the render thread
+    _released.push_back(tile.texture);
+    tile.texture = nullptr;
+  }
+  if (!tile.texture) {
+    tile.texture = allocate(size);
+    tile.size = size;
+  }
+  if (!tile.list) {
+    tile.list = IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData());
+  }
+  const float z = zoom(level);
+  tile.from = index * width * z;
+  tile.to = tile.from + width * z;
+  tile.list->_ResetForNewFrame();
+  tile.list->Flags = ImGui::GetWindowDrawList()->Flags;
+  tile.list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+  tile.list->PushClipRect({0, 0}, size);
+  tile.valid = true;
+  tile.pending = true;
+  _pending.push_back(&tile);
+  return &tile;
+}
+
+void Tiles::invalidate() {
+  for (auto &[owner, owned] : _tiles) {
+    for (auto &[index, tile] : owned) {
+      tile.valid = false;
+    }
+  }
+}
+
+void Tiles::invalidate(const void *owner) {
+  auto it = _tiles.find(owner);
+  if (it == _tiles.end()) {
+    return;
+  }
+  for (auto &[index, tile] : it->second) {
+    tile.valid = false;
+  }
+}
+
+void Tiles::invalidate(const void *owner, const double &from,
+                       const double &to) {
+  auto it = _tiles.find(owner);
+  if (it == _tiles.end()) {
+    return;
+  }
+  for (auto &[index, tile] : it->second) {
+    if (tile.from <= to && tile.to >= from) {
+      tile.valid = false;
+    }
+  }
+}
+
+void Tiles::collect() {
+  for (auto texture : _released) {
+    release(texture);
+  }
+  _released.clear();
+  const int frame = ImGui::GetFrameCount();
+  for (auto it = _tiles.begin(); it != _tiles.end();) {
+    auto &owned = it->second;
+    for (auto tile = owned.begin(); tile != owned.end();) {
+      if (frame - tile->second.used > maxAge) {
+        if (tile->second.texture) {
+          release(tile->second.texture);
+        }
+        tile = owned.erase(tile);
+      } else {
+        ++tile;
+      }
+    }
+    if (owned.empty()) {
+      it = _tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  _budget = maxPending;
+}
+
+void Tiles::take(std::vector<Job> &jobs, const bool &clone) {
+  const auto &scale = ImGui::GetIO().DisplayFramebufferScale;
+  const auto &background = ImGui::GetStyle().Colors[ImGuiCol_WindowBg];
+  for (auto tile : _pending) {
+    auto list = clone ? tile->list->CloneOutput() : tile->list;
+    jobs.push_back({tile->texture, list, tile->size, scale, background, clone});
+    tile->pending = false;
+  }
+  _pending.clear();
+}
@@ -0,0 +1,27 @@
+#include <cstdio>
+#include <maolan/ui/timecode.hpp>
+
+using namespace maolan::ui;
+
+std::string Timecode::format(const int64_t &frame, const int64_t &nominal,
+                             const bool &drop) {
+  char text[48];
+  int64_t f = frame;
+  if (drop) {
+    // drop-frame skips the first labels of every minute but each tenth
+    const int64_t drops = nominal / 15;
+    const int64_t minute = nominal * 60 - drops;
+    const int64_t tens = minute * 10 + drops;
+    const int64_t d = f / tens;
+    const int64_t m = f % tens;
+    f += 9 * drops * d + (m > drops ? drops * ((m - drops) / minute) : 0);
+  }
+  const int64_t ff = f % nominal;
+  const int64_t ss = f / nominal % 60;
+  const int64_t mm = f / nominal / 60 % 60;
+  const int64_t hh = f / nominal / 3600;
+  std::snprintf(text, sizeof(text), "%02lld:%02lld:%02lld%c%02lld",
+                (long long)hh, (long long)mm, (long long)ss, drop ? ';' : ':',
+                (long long)ff);
+  return text;
+}
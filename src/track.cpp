@@ -1,65 +1,97 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <imgui.h>
 #include <imgui_internal.h>
+#include <maolan/ui/damage.hpp>
+#include <maolan/ui/drawcache.hpp>
+#include <maolan/ui/history.hpp>
+#include <maolan/ui/peaks.hpp>
+#include <maolan/ui/snap.hpp>
+#include <maolan/ui/state.hpp>
+#include <maolan/ui/tempomap.hpp>
+#include <maolan/ui/tiles.hpp>
 #include <maolan/ui/track.hpp>
+#include <maolan/ui/transaction.hpp>
 #include <maolan/ui/widgets/clip.hpp>
 #include <maolan/ui/widgets/draglimit.hpp>
 #include <maolan/ui/widgets/hdraglimit.hpp>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 using namespace maolan::ui;
 
-Track::Labels::Labels() {
-  const std::string suffix = "##" + std::to_string((long)this);
+static auto state = State::get();
+static auto cache = DrawCache::get();
+
+Registry<maolan::audio::Track, Track> Track::registry;
+
+Track::Labels::Labels(const maolan::audio::Track *t) {
+  const std::string suffix = "##" + std::to_string((long)t);
   mute = "M" + suffix;
   solo = "S" + suffix;
   arm = "R" + suffix;
 }
 
-Track::Track(maolan::audio::Track *t) : _track{t}, grid{this} {}
+Track::Track(maolan::audio::Track *t) : _track{t}, labels{t} {}
+
+void Track::Job::run() const {
+  paint(clips, height, batch, position, from, width, zoom);
+}
 
-void Track::draw(float &width) {
+void Track::draw(float &width, Primitives::Batch *batch,
+                 std::vector<Job> *jobs) {
   ImVec2 minimum = ImGui::GetCursorScreenPos();
   ImVec2 maximum = {minimum.x + width, minimum.y + ImGui::GetTextLineHeight()};
   ImGui::BeginGroup();
   {
-    ImVec2 m = {maximum.x - 10, maximum.y};
-    ImGui::PushClipRect(minimum, m, true);
-    ImGui::Text("%s", _track->name().data());
-    ImGui::PopClipRect();
+    const auto &name = _track->name();
+    ImGui::Dummy(ImGui::CalcTextSize(name.data()));
 
     const bool muted = _track->mute();
-    if (!muted) {
-      ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(ImColor(0, 0, 0)));
-    }
-    if (ImGui::Button(labels.mute.data())) {
-      _track->mute(!muted);
-    }
-    if (!muted) {
-      ImGui::PopStyleColor();
+    if (button(labels.mute, muted, buttons[0])) {
+      Transaction transaction;
+      transaction.mute(_track, !muted);
+      Transaction::commit(std::move(transaction));
     }
 
     const bool soloed = _track->solo();
     ImGui::SameLine();
-    if (!soloed) {
-      ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(ImColor(0, 0, 0)));
-    }
-    if (ImGui::Button(labels.solo.data())) {
-      _track->solo(!soloed);
-    }
-    if (!soloed) {
-      ImGui::PopStyleColor();
+    if (button(labels.solo, soloed, buttons[1])) {
+      Transaction transaction;
+      transaction.solo(_track, !soloed);
+      Transaction::commit(std::move(transaction));
     }
 
     const bool armed = _track->arm();
     ImGui::SameLine();
-    if (!armed) {
-      ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(ImColor(0, 0, 0)));
+    if (button(labels.arm, armed, buttons[2])) {
+      Transaction transaction;
+      transaction.arm(_track, !armed);
+      Transaction::commit(std::move(transaction));
     }
-    if (ImGui::Button(labels.arm.data())) {
-      _track->arm(!armed);
+
+    std::size_t key = cache->style();
+    DrawCache::hash(key, name);
+    DrawCache::hash(key, width);
+    for (const auto &b : buttons) {
+      DrawCache::hash(key, b.min.x - minimum.x);
+      DrawCache::hash(key, b.min.y - minimum.y);
+      DrawCache::hash(key, b.color);
     }
-    if (!armed) {
-      ImGui::PopStyleColor();
+    // clipped geometry is only valid for the same visible part of the header
+    const auto drawList = ImGui::GetWindowDrawList();
+    const auto clipMin = drawList->GetClipRectMin();
+    const auto clipMax = drawList->GetClipRectMax();
+    DrawCache::hash(key, clipMin.x - minimum.x);
+    DrawCache::hash(key, clipMin.y - minimum.y);
+    DrawCache::hash(key, clipMax.x - minimum.x);
+    DrawCache::hash(key, clipMax.y - minimum.y);
+    if (!cache->replay(_track, 0, key, minimum)) {
+      cache->begin(_track, 0, key, minimum);
+      header(name, minimum, maximum);
+      cache->end();
     }
   }
   ImGui::EndGroup();
@@ -73,29 +105,278 @@ void Track::draw(float &width) {
   ImGui::SameLine();
 
   ImGui::SetCursorScreenPos(ImVec2(maximum.x, minimum.y));
-  grid.draw();
-  ImGui::SameLine();
-  ImGui::SetCursorScreenPos(ImVec2(maximum.x, minimum.y));
+  const float right = ImGui::GetWindowPos().x + ImGui::GetWindowWidth();
+  ImGui::PushClipRect({maximum.x, minimum.y}, {right, minimum.y + _height},
+                      true);
+  auto drawList = ImGui::GetWindowDrawList();
+  auto tiles = Tiles::get();
+  static Clips scratch;
+  scratch.clear();
+  drawList->ChannelsSplit(2);
+  drawList->ChannelsSetCurrent(1);
   ImGui::BeginGroup();
   {
     ImVec2 pos = ImGui::GetCursorScreenPos();
     for (auto c = _track->clips(); c != nullptr; c = c->next()) {
       ImGui::SameLine();
-      Clip *clip = (Clip *)c->data();
-      if (!clip) {
-        clip = new Clip(c);
-        c->data(clip);
+      Clip *cl = clip(c);
+      cl->draw(pos, _height);
+      double from, to;
+      if (cl->moved(from, to) && tiles) {
+        tiles->invalidate(_track, from, to);
       }
-      clip->draw(pos, _height);
+      scratch.push_back({c, c->start(), c->end(), 0});
     }
   }
   ImGui::EndGroup();
+  if (scratch.size() != _clips && tiles) {
+    tiles->invalidate(_track);
+  }
+  _clips = scratch.size();
+  snapshot(scratch);
+  drawList->ChannelsSetCurrent(0);
+  lane({maximum.x, minimum.y}, right - maximum.x, batch, jobs);
+  waves({maximum.x, minimum.y}, right - maximum.x);
+  drawList->ChannelsMerge();
+  ImGui::PopClipRect();
   minimum = ImGui::GetCursorScreenPos();
   ImGui::Separator();
   ImGui::SetCursorScreenPos(minimum);
   DragLimit(this, _height);
 }
 
+bool Track::button(const std::string &label, const bool &on, Button &b) {
+  const auto &style = ImGui::GetStyle();
+  const auto text = ImGui::CalcTextSize(label.data(), nullptr, true);
+  const ImVec2 size = {text.x + 2 * style.FramePadding.x,
+                       text.y + 2 * style.FramePadding.y};
+  const bool pressed = ImGui::InvisibleButton(label.data(), size);
+  b.min = ImGui::GetItemRectMin();
+  b.max = ImGui::GetItemRectMax();
+  b.label = label.data();
+  if (ImGui::IsItemActive()) {
+    b.color = ImGuiCol_ButtonActive;
+  } else if (ImGui::IsItemHovered()) {
+    b.color = ImGuiCol_ButtonHovered;
+  } else {
+    b.color = on ? ImGuiCol_Button : -1;
+  }
+  return pressed;
+}
+
+void Track::header(const std::string &name, const ImVec2 &minimum,
+                   const ImVec2 &maximum) {
+  const auto &style = ImGui::GetStyle();
+  const auto text = ImGui::GetColorU32(ImGuiCol_Text);
+  auto drawList = ImGui::GetWindowDrawList();
+  const ImVec4 clip = {minimum.x, minimum.y, maximum.x - 10, maximum.y};
+  drawList->AddText(ImGui::GetFont(), ImGui::GetFontSize(), minimum, text,
+                    name.data(), nullptr, 0, &clip);
+  for (const auto &b : buttons) {
+    const auto color = b.color < 0 ? ImGui::GetColorU32(ImVec4(0, 0, 0, 1))
+                                   : ImGui::GetColorU32(b.color);
+    drawList->AddRectFilled(b.min, b.max, color, style.FrameRounding);
+    if (style.FrameBorderSize > 0) {
+      drawList->AddRect(b.min, b.max, ImGui::GetColorU32(ImGuiCol_Border),
+                        style.FrameRounding, ImDrawCornerFlags_All,
+                        style.FrameBorderSize);
+    }
+    drawList->AddText({b.min.x + style.FramePadding.x,
+                       b.min.y + style.FramePadding.y},
+                      text, b.label, std::strstr(b.label, "##"));
+  }
+}
+
+Clip *Track::clip(audio::Clip *c) { return Clip::registry.get(c, _track); }
+
+void Track::lane(const ImVec2 &position, const float &width,
+                 Primitives::Batch *batch, std::vector<Job> *jobs) {
+  auto drawList = ImGui::GetWindowDrawList();
+  auto tiles = Tiles::get();
+  const int level = Tiles::level(state->zoom);
+  const float zoom = Tiles::zoom(level);
+  const double span = Tiles::width * zoom;
+  const double last = state->origin + width * state->zoom;
+  const ImVec2 size = {Tiles::width, _height};
+  static std::vector<Tiles::Tile *> visible;
+  visible.clear();
+  for (long index = state->origin / span; tiles && index * span < last;
+       ++index) {
+    auto tile = tiles->find(_track, level, index, size);
+    if (!tile) {
+      visible.clear();
+      break;
+    }
+    if (tile->pending) {
+      schedule(jobs, {&_snapshot, _height, Primitives::batch(tile->list, false),
+                      {0, 0}, tile->from, Tiles::width, zoom});
+    }
+    visible.push_back(tile);
+  }
+  if (visible.empty()) {
+    const ImVec2 maximum = {position.x + width, position.y + _height};
+    if (jobs) {
+      if (Primitives::get() && state->instanced) {
+        batch = Primitives::batch(drawList);
+      } else {
+        if (!_list) {
+          _list =
+              std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData());
+        }
+        _list->_ResetForNewFrame();
+        _list->Flags = drawList->Flags;
+        _list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+        _list->PushClipRect(position, maximum);
+        _spliced = {position.x, position.y, maximum.x, maximum.y};
+        batch = Primitives::batch(_list.get(), false);
+      }
+    }
+    batch->clip(position, maximum);
+    if (batch->instanced || jobs) {
+      schedule(jobs, {&_snapshot, _height, batch, position, state->origin,
+                      width, state->zoom});
+      return;
+    }
+    std::size_t key = 0;
+    DrawCache::hash(key, state->origin);
+    DrawCache::hash(key, state->zoom);
+    DrawCache::hash(key, width);
+    DrawCache::hash(key, _height);
+    DrawCache::hash(key, TempoMap::get()->version());
+    if (!cache->replay(_track, 1, key, position)) {
+      cache->begin(_track, 1, key, position);
+      Grid::draw(batch, position, state->origin, width, state->zoom, _height);
+      cache->end();
+    }
+    bodies(&_snapshot, _height, batch, position, state->origin, width,
+           state->zoom);
+    return;
+  }
+  for (auto tile : visible) {
+    const ImVec2 minimum = {
+        position.x + float((tile->from - state->origin) / state->zoom),
+        position.y};
+    const ImVec2 maximum = {minimum.x + float(span / state->zoom),
+                            position.y + _height};
+    if (tile->pending) {
+      Damage::get()->add(minimum, maximum);
+    }
+    drawList->AddImage(tile->texture, minimum, maximum, {0, 1}, {1, 0});
+  }
+}
+
+void Track::schedule(std::vector<Job> *jobs, const Job &job) {
+  if (jobs) {
+    jobs->push_back(job);
+  } else {
+    job.run();
+  }
+}
+
+void Track::merge(ImDrawList *drawList) {
+  if (_spliced.z <= _spliced.x) {
+    return;
+  }
+  drawList->PushClipRect({_spliced.x, _spliced.y}, {_spliced.z, _spliced.w},
+                         true);
+  DrawCache::splice(drawList, _list.get());
+  drawList->PopClipRect();
+  _spliced = {0, 0, 0, 0};
+}
+
+void Track::waves(const ImVec2 &position, const float &width) {
+  auto drawList = ImGui::GetWindowDrawList();
+  const double ahead = width * state->zoom;
+  const double to = state->origin + ahead;
+  for (const auto &span : _snapshot) {
+    if (span.start > to + ahead) {
+      break;
+    }
+    if (span.end + ahead < state->origin) {
+      continue;
+    }
+    if (span.start > to || span.end < state->origin) {
+      // a screen either side, so scrolling finds the pyramid ready
+      Peaks::get(span.clip, Scheduler::Background);
+      continue;
+    }
+    clip(span.clip)->wave(drawList, position, _height);
+  }
+}
+
+void Track::snapshot(Clips &clips) {
+  const auto earlier = [](const Span &a, const Span &b) {
+    return a.start < b.start;
+  };
+  if (!std::is_sorted(clips.begin(), clips.end(), earlier)) {
+    std::stable_sort(clips.begin(), clips.end(), earlier);
+  }
+  uint64_t reach = 0;
+  for (auto &span : clips) {
+    reach = std::max(reach, span.end);
+    span.reach = reach;
+  }
+  if (_snapshot.size() == clips.size() &&
+      std::equal(clips.begin(), clips.end(), _snapshot.begin(),
+                 [](const Span &a, const Span &b) {
+                   return a.clip == b.clip && a.start == b.start &&
+                          a.end == b.end;
+                 })) {
+    return;
+  }
+  _snapshot = clips;
+  Snap::get()->invalidate(_track);
+}
+
+void Track::paint(const Clips *clips, const float &height,
+                  Primitives::Batch *batch, const ImVec2 &position,
+                  const double &from, const float &width, const float &zoom) {
+  Grid::draw(batch, position, from, width, zoom, height);
+  bodies(clips, height, batch, position, from, width, zoom);
+}
+
+void Track::bodies(const Clips *clips, const float &height,
+                   Primitives::Batch *batch, const ImVec2 &position,
+                   const double &from, const float &width, const float &zoom) {
+  if (!clips) {
+    return;
+  }
+  const double to = from + width * zoom;
+  for (const auto &span : *clips) {
+    if (span.start > to) {
+      break;
+    }
+    if (span.end < from) {
+      continue;
+    }
+    Clip::paint(batch, position, span.start, span.end, from, zoom, height);
+  }
+}
+
+void Track::query(const Clips *clips, const double &from, const double &to,
+                  std::vector<audio::Clip *> &found) {
+  if (!clips) {
+    return;
+  }
+  auto last = std::upper_bound(
+      clips->begin(), clips->end(), to,
+      [](const double &position, const Span &span) {
+        return position < span.start;
+      });
+  for (auto it = std::make_reverse_iterator(last); it != clips->rend();
+       ++it) {
+    if (it->reach < from) {
+      break;
+    }
+    if (it->end >= from) {
+      found.push_back(it->clip);
+    }
+  }
+}
+
 float Track::height() { return _height; }
 void Track::height(float h) { _height = h; }
 maolan::audio::Track *Track::audio() { return _track; }
+const Track::Clips *Track::clips() const { return &_snapshot; }
+
+void Track::release() const { History::get()->forget(_track); }
@@ -1,35 +1,205 @@
+#include <algorithm>
+#include <cmath>
 #include <imgui.h>
+#include <imgui_internal.h>
 #include <maolan/audio/track.hpp>
+#include <maolan/ui/lod.hpp>
+#include <maolan/ui/primitives.hpp>
+#include <maolan/ui/selection.hpp>
 #include <maolan/ui/state.hpp>
+#include <maolan/ui/tempomap.hpp>
+#include <maolan/ui/tiles.hpp>
 #include <maolan/ui/track.hpp>
 #include <maolan/ui/tracks.hpp>
+#include <maolan/ui/transaction.hpp>
+#include <maolan/ui/transport.hpp>
+#include <maolan/ui/widgets/clip.hpp>
+#include <maolan/ui/workers.hpp>
 
 using namespace maolan::ui;
 
 static auto state = State::get();
+static const float minZoom = 1;
+static const float maxZoom = 1 << 30;
+static const float wheelStep = 0.25;
+static const float zoomRate = 15;
+static const float panStep = 50;
+static const int maxAge = 120;
+static const ImVec4 bandColor = {0.4, 0.6, 1, 0.15};
 
-Tracks::Tracks() : width{100}, zoom{10}, shown{true} {}
+Tracks::Tracks()
+    : width{100}, level{10}, anchor{0}, tempo{0}, bandSample{0}, bandTop{0},
+      banding{false}, shown{true} {}
 
 void Tracks::draw() {
   if (shown) {
-    ImGui::Begin("Tracks");
+    ImGui::Begin("Tracks", nullptr, ImGuiWindowFlags_NoScrollWithMouse);
     {
+      const auto &io = ImGui::GetIO();
+      const float lanes = ImGui::GetCursorScreenPos().x + width;
+      if (ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows)) {
+        if (io.KeyCtrl && io.MouseWheel != 0) {
+          zoom(state->zoomTarget * std::exp2(-io.MouseWheel * wheelStep),
+               io.MousePos.x - lanes);
+        } else if (io.KeyShift && io.MouseWheel != 0) {
+          state->origin -= io.MouseWheel * panStep * state->zoom;
+        } else if (io.MouseWheelH != 0) {
+          state->origin -= io.MouseWheelH * panStep * state->zoom;
+        } else if (io.MouseWheel != 0) {
+          ImGui::SetScrollY(ImGui::GetScrollY() -
+                            io.MouseWheel * 5 * ImGui::GetTextLineHeight());
+        }
+        if (state->origin < 0) {
+          state->origin = 0;
+        }
+      }
+      animate();
+      TempoMap::get()->sync(state->origin);
+      Transport::get()->poll();
+      Transaction::flush();
+      sync();
       timetrack.draw(width);
+      auto drawList = ImGui::GetWindowDrawList();
+      const bool parallel = state->parallel;
+      Primitives::Batch *batch = nullptr;
+      jobs.clear();
+      if (parallel) {
+        LOD{state->zoom}; // build the shared step table before workers do
+        splitter.Split(drawList, 2);
+        splitter.SetCurrentChannel(drawList, 1);
+      } else {
+        batch = Primitives::batch(drawList);
+      }
+      const float scroll = ImGui::GetScrollY();
+      rows.clear();
+      tops.clear();
       for (auto track : audio::Track::all()) {
-        Track *t = (Track *)track->data();
+        Track *t = Track::registry.get(track);
         if (t->height() < state->trackMinHeight) {
           t->height(state->trackMinHeight);
         }
-        t->draw(width);
+        rows.push_back(track);
+        tops.push_back(ImGui::GetCursorScreenPos().y + scroll);
+        t->draw(width, batch, parallel ? &jobs : nullptr);
       }
-      if (ImGui::SliderInt("zoom", &zoom, 0, 30)) {
-        state->zoom = 1 << zoom;
+      tops.push_back(ImGui::GetCursorScreenPos().y + scroll);
+      if (parallel) {
+        Workers::get()->parallel(jobs.size(),
+                                 [this](std::size_t i) { jobs[i].run(); });
+        splitter.SetCurrentChannel(drawList, 0);
+        for (auto &t : Track::registry) {
+          t.merge(drawList);
+        }
+        splitter.Merge(drawList);
+      }
+      select(lanes);
+      Track::registry.sweep(maxAge, [](Track &track) { track.release(); });
+      Clip::registry.sweep(maxAge, [](Clip &clip) { clip.release(); });
+      level = std::log2(state->zoomTarget);
+      if (ImGui::SliderFloat("zoom", &level, 0, 30, "%.1f")) {
+        zoom(std::exp2(level), 0);
       }
     }
     ImGui::End();
   }
 }
 
+void Tracks::zoom(const float &target, const float &x) {
+  state->zoomTarget = target;
+  if (state->zoomTarget < minZoom) {
+    state->zoomTarget = minZoom;
+  } else if (state->zoomTarget > maxZoom) {
+    state->zoomTarget = maxZoom;
+  }
+  anchor = x < 0 ? 0 : x;
+}
+
+void Tracks::animate() {
+  if (state->zoom == state->zoomTarget) {
+    return;
+  }
+  const float dt = ImGui::GetIO().DeltaTime;
+  const double sample = state->origin + anchor * state->zoom;
+  const float ratio = state->zoomTarget / state->zoom;
+  if (std::fabs(std::log2(ratio)) < 0.001) {
+    state->zoom = state->zoomTarget;
+  } else {
+    state->zoom *= std::pow(ratio, 1 - std::exp(-dt * zoomRate));
+  }
+  state->origin = sample - anchor * state->zoom;
+  if (state->origin < 0) {
+    state->origin = 0;
+  }
+}
+
+void Tracks::sync() {
+  const auto version = TempoMap::get()->version();
+  if (version == tempo) {
+    return;
+  }
+  tempo = version;
+  if (auto tiles = Tiles::get()) {
+    tiles->invalidate();
+  }
+}
+
+void Tracks::select(const float &lanes) {
+  if (tops.empty()) {
+    return;
+  }
+  // only the lanes themselves, the widgets below them keep their input
+  const float scroll = ImGui::GetScrollY();
+  const float right = ImGui::GetWindowPos().x + ImGui::GetWindowWidth();
+  const ImRect area{{lanes, tops.front() - scroll},
+                    {right, tops.back() - scroll}};
+  const ImGuiID id = ImGui::GetID("##band");
+  ImGui::ItemAdd(area, id);
+  bool hovered, held;
+  ImGui::ButtonBehavior(area, id, &hovered, &held);
+  const auto mouse = ImGui::GetIO().MousePos;
+  const double sample = state->origin + (mouse.x - lanes) * state->zoom;
+  if (ImGui::IsItemActivated()) {
+    bandSample = sample;
+    bandTop = mouse.y + scroll;
+    banding = true;
+  }
+  if (!banding) {
+    return;
+  }
+  const double from = std::min(bandSample, sample);
+  const double to = std::max(bandSample, sample);
+  const float top = std::min(bandTop, mouse.y + scroll);
+  const float bottom = std::max(bandTop, mouse.y + scroll);
+  if (held) {
+    const ImVec2 minimum = {lanes + float((from - state->origin) / state->zoom),
+                            top - scroll};
+    const ImVec2 maximum = {lanes + float((to - state->origin) / state->zoom),
+                            bottom - scroll};
+    auto drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(minimum, maximum,
+                            ImGui::ColorConvertFloat4ToU32(bandColor));
+    drawList->AddRect(minimum, maximum,
+                      ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.6)));
+    return;
+  }
+  banding = false;
+  found.clear();
+  if (to > from && rows.size() > 0) {
+    const auto first = std::upper_bound(tops.begin(), tops.end(), top);
+    const auto last = std::lower_bound(tops.begin(), tops.end(), bottom);
+    const std::size_t begin =
+        first == tops.begin() ? 0 : first - tops.begin() - 1;
+    const std::size_t end = std::min<std::size_t>(last - tops.begin(),
+                                                  rows.size());
+    for (auto row = begin; row < end; ++row) {
+      if (auto track = Track::registry.find(rows[row])) {
+        Track::query(track->clips(), from, to, found);
+      }
+    }
+  }
+  Selection::get()->apply(found, Selection::mode());
+}
+
 void Tracks::show() { shown = true; }
 void Tracks::hide() { shown = false; }
 void Tracks::toggle() { shown = !shown; }
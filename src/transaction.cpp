@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <maolan/ui/history.hpp>
+#include <maolan/ui/transaction.hpp>
+#include <utility>
+
+using namespace maolan::ui;
+
+std::vector<Transaction> Transaction::pending;
+
+Transaction::Transaction(const bool &transient) : _transient{transient} {}
+
+void Transaction::move(audio::Track *track, audio::Clip *clip,
+                       const uint64_t &start, const uint64_t &end) {
+  _edits.push_back({Move, track, clip, {clip->start(), clip->end()},
+                    {start, end}});
+}
+
+void Transaction::mute(audio::Track *track, const bool &on) {
+  flag(Mute, track, track->mute(), on);
+}
+
+void Transaction::solo(audio::Track *track, const bool &on) {
+  flag(Solo, track, track->solo(), on);
+}
+
+void Transaction::arm(audio::Track *track, const bool &on) {
+  flag(Arm, track, track->arm(), on);
+}
+
+void Transaction::flag(const Kind &kind, audio::Track *track,
+                       const bool &before, const bool &after) {
+  _edits.push_back({kind, track, nullptr, {before, 0}, {after, 0}});
+}
+
+void Transaction::apply(const bool &reverse) {
+  const auto visit = [reverse](Edit &edit) {
+    if (!reverse) {
+      capture(edit);
+    }
+    set(edit, reverse ? edit.before : edit.after);
+  };
+  if (reverse) {
+    std::for_each(_edits.rbegin(), _edits.rend(), visit);
+  } else {
+    std::for_each(_edits.begin(), _edits.end(), visit);
+  }
+}
+
+void Transaction::capture(Edit &edit) {
+  switch (edit.kind) {
+  case Move:
+    edit.before[0] = edit.clip->start();
+    edit.before[1] = edit.clip->end();
+    break;
+  case Mute:
+    edit.before[0] = edit.track->mute();
+    break;
+  case Solo:
+    edit.before[0] = edit.track->solo();
+    break;
+  case Arm:
+    edit.before[0] = edit.track->arm();
+    break;
+  }
+}
+
+void Transaction::set(const Edit &edit, const uint64_t *value) {
+  switch (edit.kind) {
+  case Move:
+    edit.clip->start(value[0]);
+    edit.clip->end(value[1]);
+    break;
+  case Mute:
+    edit.track->mute(value[0]);
+    break;
+  case Solo:
+    edit.track->solo(value[0]);
+    break;
+  case Arm:
+    edit.track->arm(value[0]);
+    break;
+  }
+}
+
+void Transaction::restore(
+    const std::unordered_map<audio::Clip *, std::pair<uint64_t, uint64_t>>
+        &before) {
+  for (auto &edit : _edits) {
+    if (edit.kind != Move) {
+      continue;
+    }
+    auto it = before.find(edit.clip);
+    if (it != before.end()) {
+      edit.before[0] = it->second.first;
+      edit.before[1] = it->second.second;
+    }
+  }
+}
+
+void Transaction::shrink() { _edits.shrink_to_fit(); }
+
+void Transaction::forget(const audio::Clip *clip) {
+  _edits.erase(std::remove_if(_edits.begin(), _edits.end(),
+                              [clip](const Edit &edit) {
+                                return edit.kind == Move && edit.clip == clip;
+                              }),
+               _edits.end());
+}
+
+void Transaction::forget(const audio::Track *track) {
+  _edits.erase(std::remove_if(_edits.begin(), _edits.end(),
+                              [track](const Edit &edit) {
+                                return edit.track == track;
+                              }),
+               _edits.end());
+}
+bool Transaction::empty() const { return _edits.empty(); }
+bool Transaction::transient() const { return _transient; }
+
+const std::vector<Transaction::Edit> &Transaction::edits() const {
+  return _edits;
+}
+
+void Transaction::commit(Transaction &&transaction) {
+  if (transaction.empty()) {
+    return;
+  }
+  pending.push_back(std::move(transaction));
+}
+
+void Transaction::flush() {
+  // edits only ever come from the UI thread and land at the top of a UI
+  // frame, the engine may be in the middle of an audio block when they do
+  std::vector<Transaction> batch;
+  batch.swap(pending);
+  auto history = History::get();
+  for (auto &transaction : batch) {
+    transaction.apply();
+    if (transaction.transient()) {
+      history->hold(transaction);
+    } else {
+      history->record(std::move(transaction));
+    }
+  }
+}
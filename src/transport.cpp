@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <maolan/io.hpp>
+#include <maolan/ui/state.hpp>
+#include <maolan/ui/transport.hpp>
+
+using namespace maolan::ui;
+
+static auto state = State::get();
+static const double gain = 0.1;
+static const double speedGain = 0.05;
+static const int minObservations = 8;
+static const double minInterval = 0.001;
+static const double maxInterval = 0.1;
+
+Transport *Transport::transport = nullptr;
+
+Transport::Transport()
+    : _sequence{0}, _position{0}, _time{0}, _rate{0}, _external{false},
+      _seen{0}, _observed{0}, _anchor{0}, _stamp{0}, _speed{0}, _estimate{0},
+      _changed{0}, _interval{maxInterval}, _observations{0}, _playing{false} {}
+
+Transport *Transport::get() {
+  if (transport) {
+    return transport;
+  }
+  transport = new Transport();
+  return transport;
+}
+
+double Transport::now() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Transport::publish(const uint64_t &position, const double &time,
+                        const double &rate) {
+  _sequence.fetch_add(1, std::memory_order_acq_rel);
+  _position.store(position, std::memory_order_relaxed);
+  _time.store(time, std::memory_order_relaxed);
+  _rate.store(rate, std::memory_order_relaxed);
+  _sequence.fetch_add(1, std::memory_order_release);
+  _external.store(true, std::memory_order_release);
+}
+
+bool Transport::read(uint64_t &position, double &time, double &rate) const {
+  for (int attempt = 0; attempt < 4; ++attempt) {
+    const uint64_t before = _sequence.load(std::memory_order_acquire);
+    if (before & 1) {
+      continue;
+    }
+    position = _position.load(std::memory_order_relaxed);
+    time = _time.load(std::memory_order_relaxed);
+    rate = _rate.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_sequence.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Transport::poll() {
+  const double t = now();
+  uint64_t position;
+  double time;
+  double rate;
+  if (_external.load(std::memory_order_acquire)) {
+    const uint64_t sequence = _sequence.load(std::memory_order_acquire);
+    if (sequence == _seen || !read(position, time, rate)) {
+      _playing = _playing && t - _changed < 2 * _interval;
+      return;
+    }
+    _seen = sequence;
+  } else {
+    position = IO::playHead();
+    time = t;
+    rate = state->rate;
+    if (position == _observed) {
+      _playing = _playing && t - _changed < 2 * _interval;
+      return;
+    }
+  }
+  const double elapsed = time - _changed;
+  const bool advancing = position > _observed;
+  const double moved = double(position) - double(_observed);
+  _observed = position;
+  _changed = time;
+  if (!_playing || !advancing) {
+    _anchor = position;
+    _stamp = time;
+    _speed = rate;
+    _observations = 0;
+    _playing = advancing;
+    return;
+  }
+  _interval = std::clamp(elapsed, minInterval, maxInterval);
+  // carry the prediction to now at the old speed, so a new speed estimate
+  // only bends the line from here on instead of from playback start
+  _anchor += (time - _stamp) * _speed;
+  _stamp = time;
+  if (_external.load(std::memory_order_relaxed)) {
+    _speed = rate;
+  } else if (elapsed > 0) {
+    // the nominal rate ignores varispeed and clock drift, so measure it once
+    // enough playhead updates have been seen to average out their jitter
+    const double measured = moved / elapsed;
+    _estimate = _observations == 0
+                    ? measured
+                    : _estimate + (measured - _estimate) * speedGain;
+    ++_observations;
+    _speed = _observations < minObservations ? rate : _estimate;
+  }
+  const double error = position - _anchor;
+  if (std::fabs(error) > _interval * _speed * 2) {
+    _anchor = position;
+    return;
+  }
+  _anchor += error * gain;
+}
+
+void Transport::reset() {
+  _playing = false;
+  _observations = 0;
+  _observed = IO::playHead();
+  _anchor = _observed;
+  _stamp = now();
+  _changed = _stamp;
+}
+
+double Transport::position(const double &at) const {
+  if (!_playing) {
+    return _observed;
+  }
+  return std::max(0.0, _anchor + std::max(0.0, at - _stamp) * _speed);
+}
+
+bool Transport::playing() const { return _playing; }
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <maolan/ui/damage.hpp>
+#include <maolan/ui/waveforms.hpp>
+
+using namespace maolan::ui;
+
+std::vector<Waveforms::Wave *> Waveforms::waves[2];
+std::vector<Waveforms::Wave> Waveforms::previous;
+std::size_t Waveforms::used = 0;
+int Waveforms::current = 0;
+Waveforms *Waveforms::waveforms = nullptr;
+
+static bool same(const Waveforms::Wave &a, const Waveforms::Wave &b) {
+  return a.peaks == b.peaks && a.min.x == b.min.x && a.min.y == b.min.y &&
+         a.max.x == b.max.x && a.max.y == b.max.y && a.from == b.from &&
+         a.zoom == b.zoom && a.gain == b.gain && a.split == b.split &&
+         a.color == b.color;
+}
+
+Waveforms::Waveforms() : _target{nullptr} {
+  waveforms = this;
+  Damage::get()->reported(callback);
+}
+
+Waveforms::~Waveforms() {
+  if (waveforms == this) {
+    waveforms = nullptr;
+  }
+}
+
+Waveforms *Waveforms::get() { return waveforms; }
+
+void Waveforms::draw(ImDrawList *drawList, const Wave &wave) {
+  const auto minimum = drawList->GetClipRectMin();
+  const auto maximum = drawList->GetClipRectMax();
+  Wave w = wave;
+  w.texture = nullptr;
+  if (w.min.x < minimum.x) {
+    w.from += (minimum.x - w.min.x) * w.zoom;
+    w.min.x = minimum.x;
+  }
+  w.max.x = std::min(w.max.x, maximum.x);
+  if (w.min.x >= w.max.x || w.max.y <= minimum.y || w.min.y >= maximum.y) {
+    return;
+  }
+  if (!waveforms || !waveforms->fits(*w.peaks)) {
+    fallback(drawList, w);
+    return;
+  }
+  if (!waveforms->prepare(w)) {
+    return;
+  }
+  auto &pool = waves[current];
+  if (used == pool.size()) {
+    pool.push_back(new Wave());
+  }
+  auto slot = pool[used++];
+  *slot = w;
+  drawList->AddCallback(callback, slot);
+  drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
+
+void Waveforms::finish() {
+  auto damage = Damage::get();
+  const auto &waves = Waveforms::waves[current];
+  const std::size_t common = std::min(used, previous.size());
+  for (std::size_t i = 0; i < common; ++i) {
+    const auto &now = *waves[i];
+    const auto &before = previous[i];
+    if (!same(now, before)) {
+      damage->add(now.min, now.max);
+      damage->add(before.min, before.max);
+    }
+  }
+  for (std::size_t i = common; i < used; ++i) {
+    damage->add(waves[i]->min, waves[i]->max);
+  }
+  for (std::size_t i = common; i < previous.size(); ++i) {
+    damage->add(previous[i].min, previous[i].max);
+  }
+  previous.resize(used);
+  for (std::size_t i = 0; i < used; ++i) {
+    previous[i] = *waves[i];
+  }
+  current = 1 - current;
+  used = 0;
+}
+
+void Waveforms::target(const ImDrawData *data) { _target = data; }
+
+bool Waveforms::fits(const Peaks &peaks) const { return true; }
+
+bool Waveforms::prepare(Wave &wave) { return true; }
+
+void Waveforms::callback(const ImDrawList *drawList, const ImDrawCmd *cmd) {
+  if (waveforms) {
+    waveforms->render(*(const Wave *)cmd->UserCallbackData, *cmd);
+  }
+}
+
+void Waveforms::fallback(ImDrawList *drawList, const Wave &wave) {
+  const auto &peaks = *wave.peaks;
+  const std::size_t level = peaks.level(wave.zoom);
+  const double block = double(Peaks::base << level);
+  const std::size_t lanes = wave.split ? peaks.channels : 1;
+  const float height = (wave.max.y - wave.min.y) / lanes;
+  for (float x = wave.min.x; x < wave.max.x; ++x) {
+    const double start = wave.from + (x - wave.min.x) * wave.zoom;
+    const std::size_t first = start / block;
+    const std::size_t last =
+        std::max(first + 1, std::size_t((start + wave.zoom) / block + 1));
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      ImVec2 p = {1, -1};
+      const std::size_t from = wave.split ? lane : 0;
+      const std::size_t to = wave.split ? lane + 1 : peaks.channels;
+      for (std::size_t channel = from; channel < to; ++channel) {
+        const auto v = peaks.peak(channel, level, first, last);
+        p = {channel == from ? v.x : std::min(p.x, v.x),
+             channel == from ? v.y : std::max(p.y, v.y)};
+      }
+      if (p.x > p.y) {
+        continue;
+      }
+      const float middle = wave.min.y + (lane + 0.5f) * height;
+      const float scale = 0.5f * height * wave.gain;
+      const float top = std::max(middle - p.y * scale, middle - 0.5f * height);
+      const float bottom =
+          std::min(middle - p.x * scale, middle + 0.5f * height);
+      drawList->AddRectFilled({x, top}, {x + 1, std::max(bottom, top + 1)},
+                              wave.color);
+    }
+  }
+}
@@ -1,93 +1,297 @@
+#include <algorithm>
+#include <cmath>
 #include <imgui.h>
+#include <maolan/ui/history.hpp>
+#include <maolan/ui/peaks.hpp>
+#include <maolan/ui/selection.hpp>
+#include <maolan/ui/snap.hpp>
 #include <maolan/ui/state.hpp>
+#include <maolan/ui/transaction.hpp>
+#include <maolan/ui/waveforms.hpp>
 #include <maolan/ui/widgets/clip.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace maolan::ui;
 
 static auto state = State::get();
 static const ImVec4 color = {0, 0.8, 0.8, 0.2};
+static const ImVec4 ghostColor = {0, 0.8, 0.8, 0.35};
+static const ImVec4 selectedColor = {1, 0.8, 0.2, 0.9};
+static const double auditionPeriod = 0.1;
 
-Clip::Labels::Labels() {
-  id = std::to_string((long)this);
+Registry<maolan::audio::Clip, Clip> Clip::registry;
+int64_t Clip::shift = 0;
+
+Clip::Labels::Labels(const maolan::audio::Clip *c) {
+  id = std::to_string((long)c);
   start = "start" + id;
   end = "end" + id;
 }
 
-Clip::Clip(maolan::audio::Clip *c) : _clip{c} { c->data(this); }
+Clip::Clip(maolan::audio::Clip *c, maolan::audio::Track *t)
+    : _clip{c}, _track{t}, labels{c}, _start{0}, _end{0}, _origin{0, 0},
+      _ghost{0, 0}, _auditioned{0}, _gain{1}, _lowest{0}, _handle{None},
+      _auditing{false}, _following{false}, _seen{false} {}
 
 void Clip::draw(const ImVec2 &position, const float &h) {
   const float &minHeight = state->trackMinHeight;
   const float &height = h < minHeight ? minHeight : h;
   ImDrawList *draw_list = ImGui::GetWindowDrawList();
-  const float start = (float)_clip->start() / (float)state->zoom;
-  const float end = (float)_clip->end() / (float)state->zoom;
+  const float start = (_clip->start() - state->origin) / state->zoom;
+  const float end = (_clip->end() - state->origin) / state->zoom;
   const ImVec2 minimum = {position.x + start, position.y};
   const ImVec2 maximum = {position.x + end, position.y + height};
-  const ImGuiIO &io = ImGui::GetIO();
   ImVec2 size = {end - start, height};
+  if (size.x < 7) {
+    size.x = 7;
+  }
 
   ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0.0f, 0.0f));
   ImGui::PushClipRect(minimum, maximum, true);
   ImGui::SetCursorScreenPos({minimum.x + 3, minimum.y});
   ImGui::InvisibleButton(labels.id.data(), {size.x - 6, size.y});
-  auto active = ImGui::IsItemActive();
-  auto hovered = ImGui::IsItemHovered();
-  if (hovered) {
+  if (ImGui::IsItemHovered()) {
     ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
   }
-  if (active && io.MouseDelta.x != 0) {
-    auto delta = io.MouseDelta.x * state->zoom;
-    auto newStart = _clip->start() + delta;
-    if (delta < 0) {
-      if (newStart < 0) {
-        delta -= newStart;
-        newStart = 0;
-      }
+  if (ImGui::BeginPopupContextItem()) {
+    ImGui::SliderFloat("gain", &_gain, 0.1, 10, "%.2f",
+                       ImGuiSliderFlags_Logarithmic);
+    ImGui::EndPopup();
+  }
+  auto selection = Selection::get();
+  if (ImGui::IsItemActivated()) {
+    const auto mode = Selection::mode();
+    if (mode != Selection::Replace || !selection->contains(_clip)) {
+      std::vector<maolan::audio::Clip *> clicked = {_clip};
+      selection->apply(clicked, mode);
     }
-    auto newEnd = _clip->end() + delta;
-    _clip->start(newStart);
-    _clip->end(newEnd);
   }
-  draw_list->AddRectFilled(minimum, maximum,
-                           ImGui::ColorConvertFloat4ToU32(color), 3);
+  bool ghost = drag(Body);
   draw_list->AddText(minimum, ImGui::GetColorU32(ImGuiCol_Text),
                      _clip->name().data());
   ImGui::PopClipRect();
-  draw_list->AddRect(minimum, maximum,
-                     ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.3)), 3);
 
   size.x = 3;
   ImGui::SameLine();
   ImGui::InvisibleButton(labels.end.data(), size);
-  active = ImGui::IsItemActive();
-  hovered = ImGui::IsItemHovered();
-  if (hovered) {
+  if (ImGui::IsItemHovered()) {
     ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeEW);
   }
-  if (active && io.MouseDelta.x != 0) {
-    auto newEnd = _clip->end();
-    newEnd += io.MouseDelta.x * state->zoom;
-    if (newEnd <= _clip->start()) {
-      newEnd = _clip->start() + 1;
-    }
-    _clip->end(newEnd);
-  }
+  ghost |= drag(End);
 
   ImGui::SetCursorScreenPos(minimum);
   ImGui::InvisibleButton(labels.start.data(), size);
-  active = ImGui::IsItemActive();
-  hovered = ImGui::IsItemHovered();
-  if (hovered) {
+  if (ImGui::IsItemHovered()) {
     ImGui::SetMouseCursor(ImGuiMouseCursor_ResizeEW);
   }
-  if (active && io.MouseDelta.x != 0) {
-    auto newStart = _clip->start();
-    newStart += io.MouseDelta.x * state->zoom;
-    if (newStart <= 0) {
-      newStart = 1;
+  ghost |= drag(Start);
+  ImGui::PopStyleVar();
+
+  if (selection->contains(_clip)) {
+    draw_list->AddRect(minimum, maximum,
+                       ImGui::ColorConvertFloat4ToU32(selectedColor), 3,
+                       ImDrawCornerFlags_All, 2);
+  }
+  if (_following) {
+    _ghost[0] = _origin[0] + shift;
+    _ghost[1] = _origin[1] + shift;
+    ghost = true;
+  }
+  if (ghost) {
+    const ImVec2 from = {
+        position.x + float((_ghost[0] - state->origin) / state->zoom),
+        position.y};
+    const ImVec2 to = {
+        position.x + float((_ghost[1] - state->origin) / state->zoom),
+        position.y + height};
+    draw_list->AddRectFilled(from, to,
+                             ImGui::ColorConvertFloat4ToU32(ghostColor), 3);
+    draw_list->AddRect(from, to,
+                       ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.8)),
+                       3);
+  }
+}
+
+bool Clip::drag(const Handle &handle) {
+  if (ImGui::IsItemActivated()) {
+    _handle = handle;
+    _origin[0] = _ghost[0] = _clip->start();
+    _origin[1] = _ghost[1] = _clip->end();
+    _auditioned = ImGui::GetTime();
+    group(handle);
+  }
+  if (_handle != handle) {
+    return false;
+  }
+  if (ImGui::IsItemDeactivated()) {
+    commit(_ghost[0], _ghost[1]);
+    ungroup();
+    _handle = None;
+    return true;
+  }
+  if (!ImGui::IsItemActive()) {
+    return false;
+  }
+  const double delta =
+      ImGui::GetMouseDragDelta(ImGuiMouseButton_Left, 0).x * state->zoom;
+  const double length = _origin[1] - _origin[0];
+  double start = _origin[0];
+  double end = _origin[1];
+  auto snap = Snap::get();
+  // dragged clips never snap to themselves, wherever auditioning left them
+  const auto ignore = _group.data();
+  const std::size_t ignored = _group.size();
+  // the leftmost clip of the group stops at zero
+  const double lowest = _origin[0] - _lowest;
+  double target;
+  switch (handle) {
+  case Body: {
+    start = std::max(lowest, start + delta);
+    end = start + length;
+    double offset = 0;
+    double distance = INFINITY;
+    if (snap->find(start, _track, ignore, ignored, target)) {
+      offset = target - start;
+      distance = std::fabs(offset);
+    }
+    if (snap->find(end, _track, ignore, ignored, target) &&
+        std::fabs(target - end) < distance &&
+        start + target - end >= lowest) {
+      offset = target - end;
     }
-    _clip->start(newStart);
+    start += offset;
+    end += offset;
+    break;
   }
-  ImGui::PopStyleVar();
+  case End:
+    end += delta;
+    if (snap->find(end, _track, ignore, ignored, target)) {
+      end = target;
+    }
+    end = std::max(start + 1, end);
+    break;
+  case Start:
+    start += delta;
+    if (snap->find(start, _track, ignore, ignored, target)) {
+      start = target;
+    }
+    start = std::min(end - 1, std::max(1.0, start));
+    break;
+  case None:
+    break;
+  }
+  _ghost[0] = start;
+  _ghost[1] = end;
+  shift = int64_t(_ghost[0]) - int64_t(_origin[0]);
+  const double now = ImGui::GetTime();
+  if (state->audition && now - _auditioned >= auditionPeriod) {
+    _auditioned = now;
+    commit(_ghost[0], _ghost[1], true);
+  }
+  return true;
+}
+
+void Clip::commit(const uint64_t &start, const uint64_t &end,
+                  const bool &transient) {
+  const bool unchanged = start == _clip->start() && end == _clip->end();
+  if (unchanged && (transient || !_auditing)) {
+    return;
+  }
+  _auditing = transient;
+  Transaction transaction{transient};
+  transaction.move(_track, _clip, start, end);
+  // the rest of the selection follows by the same snapped delta
+  const int64_t delta = int64_t(start) - int64_t(_origin[0]);
+  for (std::size_t i = 1; i < _group.size(); ++i) {
+    const auto member = registry.find(_group[i]);
+    if (member) {
+      transaction.move(member->_track, _group[i], member->_origin[0] + delta,
+                       member->_origin[1] + delta);
+    }
+  }
+  Transaction::commit(std::move(transaction));
+}
+
+void Clip::group(const Handle &handle) {
+  _group.assign(1, _clip);
+  _lowest = _origin[0];
+  auto selection = Selection::get();
+  if (handle != Body || !selection->contains(_clip)) {
+    return;
+  }
+  for (const auto &clip : selection->clips()) {
+    const auto member = registry.find(clip);
+    if (clip == _clip || !member) {
+      continue;
+    }
+    member->_origin[0] = clip->start();
+    member->_origin[1] = clip->end();
+    member->_following = true;
+    _lowest = std::min(_lowest, member->_origin[0]);
+    _group.push_back(clip);
+  }
+}
+
+void Clip::ungroup() {
+  for (std::size_t i = 1; i < _group.size(); ++i) {
+    const auto member = registry.find(_group[i]);
+    if (member) {
+      member->_following = false;
+    }
+  }
+  _group.clear();
+}
+
+void Clip::paint(Primitives::Batch *batch, const ImVec2 &position,
+                 const uint64_t &start, const uint64_t &end,
+                 const double &from, const float &zoom, const float &height) {
+  const ImVec2 minimum = {position.x + float((start - from) / zoom),
+                          position.y};
+  const ImVec2 maximum = {position.x + float((end - from) / zoom),
+                          position.y + height};
+  batch->rect(minimum, maximum, ImGui::ColorConvertFloat4ToU32(color), 3);
+  batch->outline(minimum, maximum,
+                 ImGui::ColorConvertFloat4ToU32(ImVec4(1, 1, 1, 0.3)), 3);
+}
+
+void Clip::wave(ImDrawList *drawList, const ImVec2 &position,
+                const float &height) {
+  auto peaks = Peaks::get(_clip);
+  if (!peaks) {
+    return;
+  }
+  Waveforms::Wave w;
+  w.peaks = peaks;
+  w.min = {position.x + float((_clip->start() - state->origin) / state->zoom),
+           position.y};
+  w.max = {position.x + float((_clip->end() - state->origin) / state->zoom),
+           position.y + height};
+  w.from = 0;
+  w.zoom = state->zoom;
+  w.gain = _gain;
+  w.split = state->split;
+  w.color = ImGui::ColorConvertFloat4ToU32(ImVec4(0.6, 1, 1, 0.8));
+  Waveforms::draw(drawList, w);
+}
+
+bool Clip::moved(double &from, double &to) {
+  const uint64_t start = _clip->start();
+  const uint64_t end = _clip->end();
+  if (_seen && start == _start && end == _end) {
+    return false;
+  }
+  from = _seen && _start < start ? _start : start;
+  to = _seen && _end > end ? _end : end;
+  _start = start;
+  _end = end;
+  _seen = true;
+  return true;
+}
+
+void Clip::release() const {
+  Peaks::forget(_clip);
+  Selection::get()->forget(_clip);
+  History::get()->forget(_clip);
 }
@@ -1,35 +1,27 @@
-#include <imgui.h>
-#include <maolan/config.hpp>
-#include <maolan/ui/state.hpp>
-#include <maolan/ui/track.hpp>
+#include <cmath>
+#include <maolan/ui/lod.hpp>
+#include <maolan/ui/tempomap.hpp>
 #include <maolan/ui/widgets/grid.hpp>
 
 using namespace maolan::ui;
 
-static const auto color = ImGui::ColorConvertFloat4ToU32({1, 1, 1, 0.2});
-static const auto state = State::get();
-static const auto spacing = ImVec2(0.0f, 0.0f);
+static const auto color = ImVec4(1, 1, 1, 0.2);
 
-Grid::Grid(Track *t) : _track{t} {}
-
-void Grid::draw() {
-  const auto &tempo = Config::tempos[Config::tempoIndex];
-  const float delta = tempo.spt / (float)state->zoom;
-  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, spacing);
-  auto position = ImGui::GetCursorScreenPos();
-  const int bars = ImGui::GetWindowWidth() / delta;
-  auto drawList = ImGui::GetWindowDrawList();
-  int nth = 0;
-  if (delta > 25) {
-    nth = 1;
-  } else {
-    for (; (delta * nth) < 25; nth += 4)
-      ;
-  }
-  for (int i = 0; i < bars; i += nth) {
-    drawList->AddLine(position, {position.x, position.y + _track->height()},
-                      color, 1);
-    position.x += nth * delta;
+void Grid::draw(Primitives::Batch *batch, const ImVec2 &position,
+                const double &from, const float &width, const float &zoom,
+                const float &height) {
+  const auto map = TempoMap::get();
+  const LOD lod(zoom);
+  const float right = position.x + width;
+  const auto at = [&](const int &bar) {
+    return position.x + float((map->sample(bar) - from) / zoom);
+  };
+  const double first = map->beat(from);
+  int bar = std::ceil(first / lod.step) * lod.step;
+  for (float x = at(bar); x < right; bar += lod.step, x = at(bar)) {
+    auto c = color;
+    c.w *= lod.alpha(bar);
+    batch->line(x, position.y, position.y + height,
+                ImGui::ColorConvertFloat4ToU32(c));
   }
-  ImGui::PopStyleVar();
 }
@@ -0,0 +1,80 @@
+#include <cmath>
+#include <imgui.h>
+#include <maolan/ui/state.hpp>
+#include <maolan/ui/widgets/markertrack.hpp>
+
+using namespace maolan::ui;
+
+static const auto state = State::get();
+static const auto spacing = ImVec2(0.0f, 0.0f);
+static const auto pointColor = ImVec4(1, 0.8, 0.2, 0.8);
+static const auto rangeColor = ImVec4(0.4, 0.6, 1, 0.25);
+static const float height = 15;
+
+void MarkerTrack::draw(const float &width) {
+  auto markers = Markers::get();
+  ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, spacing);
+  auto position = ImGui::GetCursorScreenPos();
+  ImGui::InvisibleButton("markertrack", {width, height});
+  position.x += width;
+  const float right = ImGui::GetWindowPos().x + ImGui::GetWindowWidth();
+  const double visible = (right - position.x) * state->zoom;
+  navigate(state->origin + visible / 2, visible);
+
+  _found.clear();
+  markers->visible(state->origin, state->origin + visible, _found);
+  auto drawList = ImGui::GetWindowDrawList();
+  const auto text = ImGui::GetColorU32(ImGuiCol_Text);
+  const auto x = [&](const uint64_t &sample) {
+    return position.x + float((sample - state->origin) / state->zoom);
+  };
+  drawList->PushClipRect(position, {right, position.y + height}, true);
+  for (const auto m : _found) {
+    if (m->end == m->start) {
+      continue;
+    }
+    const float left = std::max(position.x, x(m->start));
+    drawList->AddRectFilled({left, position.y},
+                            {x(m->end), position.y + height},
+                            ImGui::ColorConvertFloat4ToU32(rangeColor));
+    drawList->AddText({left + 3, position.y}, text, m->name.data());
+  }
+  float line = -INFINITY;
+  float label = -INFINITY;
+  const auto color = ImGui::ColorConvertFloat4ToU32(pointColor);
+  for (const auto m : _found) {
+    if (m->end != m->start) {
+      continue;
+    }
+    const float at = x(m->start);
+    if (at - line < 1) {
+      continue;
+    }
+    line = at;
+    drawList->AddLine({at, position.y}, {at, position.y + height}, color, 2);
+    if (at >= label) {
+      drawList->AddText({at + 3, position.y}, text, m->name.data());
+      label = at + ImGui::CalcTextSize(m->name.data()).x + 6;
+    }
+  }
+  drawList->PopClipRect();
+  ImGui::PopStyleVar();
+}
+
+void MarkerTrack::navigate(const double &center, const double &visible) {
+  const auto &io = ImGui::GetIO();
+  if (!io.KeyAlt ||
+      !ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows)) {
+    return;
+  }
+  uint64_t target;
+  bool found = false;
+  if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_RightArrow))) {
+    found = Markers::get()->next(std::floor(center), target);
+  } else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_LeftArrow))) {
+    found = Markers::get()->previous(std::ceil(center), target);
+  }
+  if (found) {
+    state->origin = std::max(0.0, target - visible / 2);
+  }
+}
@@ -1,7 +1,6 @@
 #include <imgui.h>
-#include <maolan/config.hpp>
-#include <maolan/io.hpp>
 #include <maolan/ui/state.hpp>
+#include <maolan/ui/transport.hpp>
 #include <maolan/ui/widgets/playhead.hpp>
 #include <string>
 
@@ -11,12 +10,13 @@ static const auto state = State::get();
 static const auto color = ImGui::ColorConvertFloat4ToU32({1, 0, 0, 0.6});
 
 void PlayHead::draw(const float &width, const float &height) {
-  const auto &playhead = IO::playHead();
-  const auto &tempo = Config::tempos[Config::tempoIndex];
-  const float delta = tempo.spt / (float)state->zoom;
+  const double playhead = Transport::get()->position(state->present);
+  if (playhead < state->origin) {
+    return;
+  }
   auto position = ImGui::GetCursorScreenPos();
   position.x += width;
-  position.x += playhead / state->zoom;
+  position.x += float((playhead - state->origin) / state->zoom);
   auto drawList = ImGui::GetWindowDrawList();
   drawList->AddTriangleFilled({position.x - 3, position.y},
                               {position.x, position.y + height},
@@ -1,42 +1,210 @@
+#include <cmath>
+#include <cstdio>
 #include <imgui.h>
-#include <maolan/config.hpp>
+#include <maolan/ui/drawcache.hpp>
+#include <maolan/ui/glyphs.hpp>
+#include <maolan/ui/lod.hpp>
 #include <maolan/ui/state.hpp>
+#include <maolan/ui/tempomap.hpp>
+#include <maolan/ui/timecode.hpp>
 #include <maolan/ui/widgets/timetrack.hpp>
 #include <string>
 
 using namespace maolan::ui;
 
 static const auto state = State::get();
+static const auto cache = DrawCache::get();
+static const auto glyphs = Glyphs::get();
 static const auto spacing = ImVec2(0.0f, 0.0f);
-static const auto color = ImGui::ColorConvertFloat4ToU32({1, 1, 1, 0.2});
+static const auto color = ImVec4(1, 1, 1, 0.2);
 static const float height = 15;
+static const float minLabel = 70;
+static const float minTick = 8;
+static const float labelGap = 6;
+static const int64_t seconds[] = {1,  2,   5,   10,  15,   30,  60,
+                                  120, 300, 600, 900, 1800, 3600};
+static const int64_t milliseconds[] = {1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+const TimeTrack::Rate TimeTrack::rates[] = {
+    {"23.976", 24000.0 / 1001, 24, false},
+    {"24", 24, 24, false},
+    {"25", 25, 25, false},
+    {"29.97 DF", 30000.0 / 1001, 30, true},
+    {"30", 30, 30, false},
+    {"50", 50, 50, false},
+    {"60", 60, 60, false}};
+const int TimeTrack::rateCount = sizeof(rates) / sizeof(rates[0]);
 
 void TimeTrack::draw(const float &width) {
+  _markers.draw(width);
   _playhead.draw(width, height);
   ImGui::BeginGroup();
   {
-    const auto &tempo = Config::tempos[Config::tempoIndex];
-    const float delta = tempo.spt / (float)state->zoom;
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, spacing);
     auto position = ImGui::GetCursorScreenPos();
     ImGui::InvisibleButton("timetrack", {width, height});
     position.x += width;
-    const int bars = ImGui::GetWindowWidth() / delta;
     auto drawList = ImGui::GetWindowDrawList();
-    int nth = 0;
-    if (delta > 25) {
-      nth = 1;
-    } else {
-      for (; (delta * nth) < 25; nth += 4)
-        ;
-    }
-    for (int i = 0; i < bars; i += nth) {
-      drawList->AddLine(position, {position.x, position.y + height}, color, 1);
-      drawList->AddText({position.x + 3, position.y}, color,
-                        std::to_string(i + 1).data());
-      position.x += nth * delta;
+    const float right = drawList->GetClipRectMax().x;
+    const auto clip = drawList->GetClipRectMin();
+    std::size_t key = cache->style();
+    DrawCache::hash(key, clip.x - position.x);
+    DrawCache::hash(key, clip.y - position.y);
+    DrawCache::hash(key, drawList->GetClipRectMax().y - position.y);
+    DrawCache::hash(key, state->origin);
+    DrawCache::hash(key, state->zoom);
+    DrawCache::hash(key, right - position.x);
+    DrawCache::hash(key, TempoMap::get()->version());
+    DrawCache::hash(key, state->ruler);
+    DrawCache::hash(key, state->fps);
+    DrawCache::hash(key, state->rate);
+    if (!cache->replay(this, 0, key, position)) {
+      cache->begin(this, 0, key, position);
+      if (state->ruler == Bars) {
+        bars(drawList, position, right);
+      } else {
+        ticks(drawList, position, right);
+      }
+      cache->end();
     }
+    glyphs->sweep();
     ImGui::PopStyleVar();
   }
   ImGui::EndGroup();
 }
+
+void TimeTrack::bars(ImDrawList *drawList, const ImVec2 &position,
+                     const float &right) {
+  const auto map = TempoMap::get();
+  const LOD lod(state->zoom);
+  const auto at = [&](const int &beat) {
+    return position.x +
+           float((map->sample(beat) - state->origin) / state->zoom);
+  };
+  const double first = map->beat(state->origin);
+  int beat = std::ceil(first / lod.step) * lod.step;
+  float label = -INFINITY;
+  for (float x = at(beat); x < right; beat += lod.step, x = at(beat)) {
+    auto c = color;
+    c.w *= lod.alpha(beat);
+    const auto u32 = ImGui::ColorConvertFloat4ToU32(c);
+    drawList->AddLine({x, position.y}, {x, position.y + height}, u32, 1);
+    if (x < label) {
+      continue;
+    }
+    const Glyphs::Key k = {Bars, beat, map->version()};
+    auto run = glyphs->find(k);
+    if (!run) {
+      const double bar = map->bar(beat);
+      const int whole = std::floor(bar + 1e-9);
+      const auto &segment = map->segments()[map->find(beat)];
+      const int part = std::lround((bar - whole) * segment.numerator);
+      std::string text = std::to_string(whole + 1);
+      if (part > 0) {
+        text += "." + std::to_string(part + 1);
+      }
+      run = glyphs->shape(k, text);
+    }
+    Glyphs::draw(drawList, run, {x + 3, position.y}, u32);
+    label = x + run->width + labelGap;
+  }
+}
+
+void TimeTrack::ticks(ImDrawList *drawList, const ImVec2 &position,
+                      const float &right) {
+  const auto &rate = rates[state->fps];
+  double unit = 1;
+  auto &ladder = _ladder;
+  ladder.clear();
+  if (state->ruler == Timecode) {
+    unit = state->rate / rate.fps;
+    for (const int64_t frames : {1, 2, 5, 10}) {
+      ladder.push_back(frames);
+    }
+    for (const auto s : seconds) {
+      ladder.push_back(s * rate.nominal);
+    }
+  } else if (state->ruler == MinSec) {
+    unit = state->rate / 1000;
+    for (const auto ms : milliseconds) {
+      ladder.push_back(ms);
+    }
+    for (const auto s : seconds) {
+      ladder.push_back(s * 1000);
+    }
+  } else {
+    for (int64_t decade = 1; decade <= (int64_t)1e12; decade *= 10) {
+      for (const int64_t m : {1, 2, 5}) {
+        ladder.push_back(m * decade);
+      }
+    }
+  }
+  const double pixels = unit / state->zoom;
+  std::size_t major = 0;
+  while (major + 1 < ladder.size() && ladder[major] * pixels < minLabel) {
+    ++major;
+  }
+  // timecode and long sample counts outgrow minLabel, so widen the step
+  // until the widest label in view fits between majors
+  const double last =
+      (state->origin + (right - position.x) * state->zoom) / unit;
+  while (major + 1 < ladder.size()) {
+    const int64_t value = int64_t(last) / ladder[major] * ladder[major];
+    const auto text = format(value, ladder[major]);
+    if (ladder[major] * pixels >=
+        ImGui::CalcTextSize(text.c_str()).x + labelGap) {
+      break;
+    }
+    ++major;
+  }
+  const int64_t step = ladder[major];
+  int64_t minor = step;
+  for (std::size_t i = major; i-- > 0 && ladder[i] * pixels >= minTick;) {
+    if (step % ladder[i] == 0) {
+      minor = ladder[i];
+      break;
+    }
+  }
+  const auto u32 = ImGui::ColorConvertFloat4ToU32(color);
+  const auto at = [&](const int64_t &value) {
+    return position.x + float((value * unit - state->origin) / state->zoom);
+  };
+  int64_t value = std::ceil(state->origin / unit / minor) * minor;
+  for (float x = at(value); x < right; value += minor, x = at(value)) {
+    if (value % step != 0) {
+      drawList->AddLine({x, position.y + height / 2},
+                        {x, position.y + height}, u32, 1);
+      continue;
+    }
+    drawList->AddLine({x, position.y}, {x, position.y + height}, u32, 1);
+    const Glyphs::Key k = {state->ruler, value,
+                           uint64_t(state->fps) << 1 | (step % 1000 != 0)};
+    auto run = glyphs->find(k);
+    if (!run) {
+      run = glyphs->shape(k, format(value, step));
+    }
+    Glyphs::draw(drawList, run, {x + 3, position.y}, u32);
+  }
+}
+
+std::string TimeTrack::format(const int64_t &value, const int64_t &step) {
+  char text[32];
+  if (state->ruler == Timecode) {
+    const auto &rate = rates[state->fps];
+    return Timecode::format(value, rate.nominal, rate.drop);
+  } else if (state->ruler == MinSec) {
+    const int64_t ms = value % 1000;
+    const int64_t s = value / 1000 % 60;
+    const int64_t m = value / 60000;
+    if (step % 1000 == 0) {
+      std::snprintf(text, sizeof(text), "%lld:%02lld", (long long)m,
+                    (long long)s);
+    } else {
+      std::snprintf(text, sizeof(text), "%lld:%02lld.%03lld", (long long)m,
+                    (long long)s, (long long)ms);
+    }
+  } else {
+    std::snprintf(text, sizeof(text), "%lld", (long long)value);
+  }
+  return text;
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <atomic>
+#include <maolan/ui/workers.hpp>
+#include <memory>
+
+using namespace maolan::ui;
+
+Workers *Workers::workers = nullptr;
+
+Workers::Workers() : _quit{false} {
+  std::size_t count = std::thread::hardware_concurrency();
+  if (count > 1) {
+    --count;
+  }
+  if (count == 0) {
+    count = 1;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    _threads.emplace_back(&Workers::run, this);
+  }
+}
+
+Workers::~Workers() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quit = true;
+  }
+  _condition.notify_all();
+  for (auto &thread : _threads) {
+    thread.join();
+  }
+}
+
+Workers *Workers::get() {
+  if (workers) {
+    return workers;
+  }
+  workers = new Workers();
+  return workers;
+}
+
+void Workers::post(const std::function<void()> &job) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _jobs.push_back(job);
+  }
+  _condition.notify_one();
+}
+
+void Workers::parallel(const std::size_t &count,
+                       const std::function<void(std::size_t)> &job) {
+  if (count == 0) {
+    return;
+  }
+  struct Group {
+    std::function<void(std::size_t)> job;
+    std::size_t count;
+    std::atomic<std::size_t> next;
+    std::size_t done;
+    std::mutex mutex;
+    std::condition_variable condition;
+  };
+  auto group = std::make_shared<Group>();
+  group->job = job;
+  group->count = count;
+  group->next = 0;
+  group->done = 0;
+  auto work = [group] {
+    std::size_t finished = 0;
+    for (std::size_t i = group->next++; i < group->count; i = group->next++) {
+      group->job(i);
+      ++finished;
+    }
+    if (finished > 0) {
+      std::lock_guard<std::mutex> lock(group->mutex);
+      group->done += finished;
+      if (group->done == group->count) {
+        group->condition.notify_all();
+      }
+    }
+  };
+  const std::size_t helpers = std::min(_threads.size(), count - 1);
+  for (std::size_t i = 0; i < helpers; ++i) {
+    post(work);
+  }
+  work();
+  std::unique_lock<std::mutex> lock(group->mutex);
+  group->condition.wait(lock, [&] { return group->done == group->count; });
+}
+
+std::size_t Workers::size() const { return _threads.size(); }
+
+void Workers::run() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] { return _quit || !_jobs.empty(); });
+      if (_quit) {
+        return;
+      }
+      job = std::move(_jobs.front());
+      _jobs.pop_front();
+    }
+    job();
+  }
+}
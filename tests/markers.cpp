@@ -0,0 +1,64 @@
+#include "check.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <maolan/ui/markers.hpp>
+#include <string>
+#include <vector>
+
+using namespace maolan::ui;
+
+static std::vector<std::string> visible(const Markers *markers,
+                                        const double &from, const double &to) {
+  std::vector<const Markers::Marker *> found;
+  markers->visible(from, to, found);
+  std::vector<std::string> names;
+  for (const auto m : found) {
+    names.push_back(m->name);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+int main() {
+  auto markers = Markers::get();
+  const auto version = markers->version();
+  std::vector<Markers::Marker> added = {{300, 300, "c", 0},
+                                        {100, 100, "a", 0},
+                                        {200, 200, "b", 0},
+                                        {50, 1000, "long", 0},
+                                        {400, 450, "short", 0}};
+  markers->add(added);
+  // a reversed range is clamped to a point
+  markers->add(600, 500, "d");
+  CHECK(markers->size() == 6);
+  CHECK(markers->version() > version);
+
+  using Names = std::vector<std::string>;
+  CHECK(visible(markers, 150, 250) == Names({"b", "long"}));
+  CHECK(visible(markers, 100, 100) == Names({"a", "long"}));
+  CHECK(visible(markers, 420, 430) == Names({"long", "short"}));
+  // a range that started long before the view is still found through reach
+  CHECK(visible(markers, 900, 950) == Names({"long"}));
+  CHECK(visible(markers, 1001, 2000).empty());
+  CHECK(visible(markers, 0, 10).empty());
+
+  uint64_t target = 0;
+  CHECK(markers->next(0, target) && target == 50);
+  CHECK(markers->next(100, target) && target == 200);
+  CHECK(markers->next(450, target) && target == 600);
+  CHECK(!markers->next(600, target));
+  CHECK(markers->previous(600, target) && target == 400);
+  CHECK(markers->previous(100.5, target) && target == 100);
+  CHECK(!markers->previous(50, target));
+
+  std::vector<uint64_t> positions;
+  markers->positions(positions);
+  std::sort(positions.begin(), positions.end());
+  CHECK(positions ==
+        std::vector<uint64_t>({50, 100, 200, 300, 400, 450, 600, 1000}));
+
+  markers->clear();
+  CHECK(markers->size() == 0);
+  CHECK(visible(markers, 0, 2000).empty());
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include "check.hpp"
+#include <maolan/ui/registry.hpp>
+#include <vector>
+
+using namespace maolan::ui;
+
+class Key {
+public:
+  void *data() { return _data; }
+  void data(void *d) { _data = d; }
+
+protected:
+  void *_data = nullptr;
+};
+
+class Value {
+public:
+  Value(Key *k) : key{k} {}
+
+  Key *key;
+};
+
+int main() {
+  Registry<Key, Value> registry;
+  Key a;
+  Key b;
+  auto value = registry.get(&a);
+  CHECK(value->key == &a);
+  CHECK(registry.get(&a) == value);
+  CHECK(registry.find(&a) == value);
+  CHECK(registry.find(&b) == nullptr);
+
+  // objects keep their address while the registry grows
+  std::vector<Key> keys(1000);
+  for (auto &key : keys) {
+    registry.get(&key);
+  }
+  CHECK(registry.find(&a) == value);
+  CHECK(registry.size() == keys.size() + 1);
+
+  // everything unused for longer than the age is released and reclaimed
+  int released = 0;
+  registry.sweep(0, [&released](Value &) { ++released; });
+  CHECK(released == 0);
+  registry.get(&a);
+  registry.sweep(0, [&released](Value &) { ++released; });
+  CHECK(released == int(keys.size()));
+  CHECK(registry.size() == 1);
+  CHECK(registry.find(&keys.front()) == nullptr);
+  CHECK(registry.find(&a) == value);
+
+  // a reused slot gets a new generation, the stale handle stays dead
+  auto reused = registry.get(&b);
+  CHECK(reused->key == &b);
+  CHECK(registry.find(&b) == reused);
+  for (const auto &key : keys) {
+    CHECK(registry.find(&key) == nullptr);
+  }
+  CHECK(registry.find(&a) == value);
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include "check.hpp"
+#include <cmath>
+#include <maolan/ui/tempomap.hpp>
+#include <vector>
+
+using namespace maolan::ui;
+
+class Map : public TempoMap {
+public:
+  Map(const std::vector<Segment> &segments) {
+    _segments = segments;
+    rebuild();
+  }
+};
+
+static bool near(const double &a, const double &b, const double &tolerance) {
+  return std::fabs(a - b) <= tolerance;
+}
+
+static void roundTrip(const TempoMap &map, const double &last) {
+  for (double beat = 0; beat <= last; beat += 0.125) {
+    CHECK(near(map.beat(map.sample(beat)), beat, 1e-6));
+  }
+}
+
+int main() {
+  const Map constant({{0, 0, 0, 24000, 24000, 4, 4, false}});
+  CHECK(constant.sample(3) == 72000);
+  CHECK(constant.beat(72000) == 3);
+  roundTrip(constant, 64);
+
+  // slowing down: samples per beat ramp from 12000 to 24000 over 8 beats
+  const Map down({{0, 0, 0, 12000, 0, 4, 4, true},
+                  {8, 0, 0, 24000, 0, 4, 4, false}});
+  CHECK(near(down.sample(8), 8 * (12000 + 24000) / 2.0, 1e-6));
+  CHECK(near(down.segments()[1].sample, down.sample(8), 1e-6));
+  CHECK(near(down.spt(4), 18000, 1e-3));
+  CHECK(near(down.sample(10), down.sample(8) + 2 * 24000, 1e-6));
+  roundTrip(down, 16);
+
+  // speeding up, with a constant segment in between two ramps
+  const Map up({{0, 0, 0, 24000, 0, 4, 4, true},
+                {4, 0, 0, 6000, 0, 3, 4, false},
+                {6, 0, 0, 6000, 0, 4, 4, true},
+                {10, 0, 0, 30000, 0, 4, 4, false}});
+  CHECK(near(up.sample(4), 4 * (24000 + 6000) / 2.0, 1e-6));
+  CHECK(near(up.sample(6), up.sample(4) + 2 * 6000, 1e-6));
+  CHECK(up.find(5) == 1);
+  CHECK(near(up.bar(6), 1 + 2 / 3.0, 1e-9));
+  roundTrip(up, 16);
+  return 0;
+}
@@ -0,0 +1,27 @@
+#include "check.hpp"
+#include <maolan/ui/timecode.hpp>
+
+using namespace maolan::ui;
+
+int main() {
+  CHECK(Timecode::format(0, 25, false) == "00:00:00:00");
+  CHECK(Timecode::format(24, 25, false) == "00:00:00:24");
+  CHECK(Timecode::format(25 * 3600, 25, false) == "01:00:00:00");
+  CHECK(Timecode::format(24 * 61 + 3, 24, false) == "00:01:01:03");
+
+  // 29.97 drop-frame skips ;00 and ;01 at every minute but each tenth
+  CHECK(Timecode::format(1799, 30, true) == "00:00:59;29");
+  CHECK(Timecode::format(1800, 30, true) == "00:01:00;02");
+  CHECK(Timecode::format(3597, 30, true) == "00:01:59;29");
+  CHECK(Timecode::format(3598, 30, true) == "00:02:00;02");
+  CHECK(Timecode::format(17981, 30, true) == "00:09:59;29");
+  CHECK(Timecode::format(17982, 30, true) == "00:10:00;00");
+  CHECK(Timecode::format(17982 + 1800, 30, true) == "00:11:00;02");
+  CHECK(Timecode::format(107892, 30, true) == "01:00:00;00");
+
+  // 59.94 drop-frame skips four labels instead of two
+  CHECK(Timecode::format(3599, 60, true) == "00:00:59;59");
+  CHECK(Timecode::format(3600, 60, true) == "00:01:00;04");
+  CHECK(Timecode::format(215784, 60, true) == "01:00:00;00");
+  return 0;
+}
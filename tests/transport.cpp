@@ -0,0 +1,56 @@
+#include "check.hpp"
+#include <cmath>
+#include <maolan/ui/transport.hpp>
+
+using namespace maolan::ui;
+
+static const double rate = 48000;
+
+class Clock : public Transport {
+public:
+  void tick(const uint64_t &position, const double &time,
+            const double &r = rate) {
+    publish(position, time, r);
+    poll();
+  }
+};
+
+static bool near(const double &a, const double &b) {
+  return std::fabs(a - b) < 1e-6;
+}
+
+int main() {
+  Clock clock;
+  clock.tick(0, 0);
+  CHECK(!clock.playing());
+  CHECK(clock.position(1) == 0);
+
+  // the first advancing update starts playback from where it landed
+  clock.tick(480, 0.01);
+  CHECK(clock.playing());
+  CHECK(near(clock.position(0.01), 480));
+  CHECK(near(clock.position(0.02), 960));
+  CHECK(near(clock.position(0.005), 480));
+
+  // on-time updates keep the line, late ones are only pulled in gently
+  clock.tick(960, 0.02);
+  CHECK(near(clock.position(0.05), 2400));
+  clock.tick(1450, 0.03);
+  CHECK(near(clock.position(0.03), 1441));
+
+  // a rate change bends the line from the latest update, not from the start
+  clock.tick(1920, 0.04, 2 * rate);
+  const double anchored = clock.position(0.04);
+  CHECK(std::fabs(anchored - 1920) < 1);
+  CHECK(near(clock.position(0.05), anchored + 0.01 * 2 * rate));
+
+  // a locate snaps straight to the new position
+  clock.tick(480000, 0.05, 2 * rate);
+  CHECK(near(clock.position(0.05), 480000));
+
+  // going backwards stops extrapolation until playback advances again
+  clock.tick(1000, 0.06);
+  CHECK(!clock.playing());
+  CHECK(clock.position(1) == 1000);
+  return 0;
+}